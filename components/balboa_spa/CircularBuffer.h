@@ -38,6 +38,16 @@ namespace balboa_spa {
                 return this->backingQue.size();
             }
 
+            // Approximate heap held by the backing deque. libstdc++ allocates
+            // 512 byte nodes and a node map of at least 8 pointers up front,
+            // so even an empty buffer costs a full node.
+            size_t heap_bytes() const {
+                const size_t elements_per_node = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+                const size_t nodes = this->backingQue.size() / elements_per_node + 1;
+                const size_t map_entries = std::max<size_t>(8, nodes + 2);
+                return nodes * elements_per_node * sizeof(T) + map_entries * sizeof(T *);
+            }
+
             size_t copyToArray(T *arr) {
                 for (size_t offset = 0; offset < this->backingQue.size(); offset++) {
                     arr[offset] = this->backingQue[offset];
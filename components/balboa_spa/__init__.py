@@ -1,7 +1,9 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
+from esphome import pins
+from esphome.components import time as time_
 from esphome.components import uart
-from esphome.const import CONF_ID
+from esphome.const import CONF_FLOW_CONTROL_PIN, CONF_ID, CONF_TIME_ID, CONF_UPDATE_INTERVAL
 
 DEPENDENCIES = ['uart']
 AUTO_LOAD = ['sensor', 'binary_sensor', 'switch']
@@ -9,6 +11,29 @@ AUTO_LOAD = ['sensor', 'binary_sensor', 'switch']
 CONF_SPA_ID = "balboa_spa_id"
 CONF_SPA_TEMP_SCALE = "spa_temp_scale"
 CONF_ESPHOME_TEMP_SCALE = "esphome_temp_scale"
+CONF_FILTER_PERSIST_INTERVAL = "filter_persist_interval"
+CONF_HISTORY_HOURS = "history_hours"
+CONF_TOGGLE_RETRIES = "toggle_retries"
+CONF_WRITE_CONFIRM_FRAMES = "write_confirm_frames"
+CONF_WRITE_RETRIES = "write_retries"
+CONF_ECHO_CHECK = "echo_check"
+CONF_ENERGY = "energy"
+CONF_PERSIST_INTERVAL = "persist_interval"
+CONF_CLOCK_SYNC = "clock_sync"
+CONF_THRESHOLD = "threshold"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_MIN_PUBLISH_INTERVAL = "min_publish_interval"
+CONF_DEADBAND = "deadband"
+CONF_REFRESH_INTERVAL = "refresh_interval"
+CONF_WARM_START = "warm_start"
+
+# Per-entity publish limits, applied by the BalboaSpa parent
+PUBLISH_INTERVAL_SCHEMA = cv.Schema({
+    cv.Optional(CONF_MIN_PUBLISH_INTERVAL, default="0ms"): cv.positive_time_period_milliseconds,
+})
+PUBLISH_LIMIT_SCHEMA = PUBLISH_INTERVAL_SCHEMA.extend({
+    cv.Optional(CONF_DEADBAND, default=0.0): cv.positive_float,
+})
 
 balboa_spa_ns = cg.esphome_ns.namespace('balboa_spa')
 BalboaSpa = balboa_spa_ns.class_('BalboaSpa', cg.Component, uart.UARTDevice)
@@ -20,10 +45,57 @@ TEMP_SCALES = {
  "C": TEMP_SCALE.C,
 }
 
+SpaLoad = balboa_spa_ns.enum("SpaLoad")
+
+# Nameplate power options: key -> (load, speed); speed 1 is low or single speed, 2 is high
+LOAD_POWERS = {
+    "heater_power": (SpaLoad.LOAD_HEATER, 1),
+    "pump1_low_power": (SpaLoad.LOAD_PUMP1, 1),
+    "pump1_high_power": (SpaLoad.LOAD_PUMP1, 2),
+    "pump2_low_power": (SpaLoad.LOAD_PUMP2, 1),
+    "pump2_high_power": (SpaLoad.LOAD_PUMP2, 2),
+    "pump3_low_power": (SpaLoad.LOAD_PUMP3, 1),
+    "pump3_high_power": (SpaLoad.LOAD_PUMP3, 2),
+    "blower_power": (SpaLoad.LOAD_BLOWER, 1),
+    "circulation_power": (SpaLoad.LOAD_CIRCULATION, 1),
+    "pump4_low_power": (SpaLoad.LOAD_PUMP4, 1),
+    "pump4_high_power": (SpaLoad.LOAD_PUMP4, 2),
+    "pump5_low_power": (SpaLoad.LOAD_PUMP5, 1),
+    "pump5_high_power": (SpaLoad.LOAD_PUMP5, 2),
+    "pump6_low_power": (SpaLoad.LOAD_PUMP6, 1),
+    "pump6_high_power": (SpaLoad.LOAD_PUMP6, 2),
+}
+
+ENERGY_SCHEMA = cv.Schema({
+    cv.Optional(CONF_UPDATE_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_PERSIST_INTERVAL, default="60min"): cv.positive_time_period_milliseconds,
+}).extend({cv.Optional(key): cv.power for key in LOAD_POWERS})
+
+WARM_START_SCHEMA = cv.Schema({
+    cv.Optional(CONF_PERSIST_INTERVAL, default="60min"): cv.positive_time_period_milliseconds,
+})
+
+CLOCK_SYNC_SCHEMA = cv.Schema({
+    cv.Required(CONF_TIME_ID): cv.use_id(time_.RealTimeClock),
+    cv.Optional(CONF_THRESHOLD, default="30s"): cv.positive_time_period_seconds,
+    cv.Optional(CONF_MIN_INTERVAL, default="1h"): cv.positive_time_period_milliseconds,
+})
+
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(BalboaSpa),
     cv.Optional(CONF_SPA_TEMP_SCALE, default=254): cv.enum(TEMP_SCALES, upper=True),
     cv.Optional(CONF_ESPHOME_TEMP_SCALE, default="C"): cv.enum(TEMP_SCALES, upper=True),
+    cv.Optional(CONF_FILTER_PERSIST_INTERVAL, default="60min"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_HISTORY_HOURS, default=0): cv.int_range(min=0, max=48),
+    cv.Optional(CONF_TOGGLE_RETRIES, default=3): cv.int_range(min=0, max=10),
+    cv.Optional(CONF_WRITE_CONFIRM_FRAMES, default=5): cv.int_range(min=1, max=50),
+    cv.Optional(CONF_WRITE_RETRIES, default=3): cv.int_range(min=0, max=10),
+    cv.Optional(CONF_ECHO_CHECK, default=False): cv.boolean,
+    cv.Optional(CONF_REFRESH_INTERVAL, default="5min"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_FLOW_CONTROL_PIN): pins.gpio_output_pin_schema,
+    cv.Optional(CONF_ENERGY): ENERGY_SCHEMA,
+    cv.Optional(CONF_CLOCK_SYNC): CLOCK_SYNC_SCHEMA,
+    cv.Optional(CONF_WARM_START): WARM_START_SCHEMA,
 }).extend(cv.COMPONENT_SCHEMA).extend(uart.UART_DEVICE_SCHEMA)
 
 def to_code(config):
@@ -36,4 +108,32 @@ def to_code(config):
     if esphome_temp_scale_conf := config.get(CONF_ESPHOME_TEMP_SCALE):
         cg.add(var.set_esphome_temp_scale(esphome_temp_scale_conf))
 
+    cg.add(var.set_filter_persist_interval(config[CONF_FILTER_PERSIST_INTERVAL]))
+    cg.add(var.set_history_hours(config[CONF_HISTORY_HOURS]))
+    cg.add(var.set_toggle_retries(config[CONF_TOGGLE_RETRIES]))
+    cg.add(var.set_write_confirm_frames(config[CONF_WRITE_CONFIRM_FRAMES]))
+    cg.add(var.set_write_retries(config[CONF_WRITE_RETRIES]))
+    cg.add(var.set_echo_check(config[CONF_ECHO_CHECK]))
+    cg.add(var.set_refresh_interval(config[CONF_REFRESH_INTERVAL]))
+
+    if flow_control_pin_conf := config.get(CONF_FLOW_CONTROL_PIN):
+        flow_control_pin = yield cg.gpio_pin_expression(flow_control_pin_conf)
+        cg.add(var.set_flow_control_pin(flow_control_pin))
+
+    if energy_conf := config.get(CONF_ENERGY):
+        for key, (load, speed) in LOAD_POWERS.items():
+            if key in energy_conf:
+                cg.add(var.set_load_power(load, speed, energy_conf[key]))
+        cg.add(var.set_energy_update_interval(energy_conf[CONF_UPDATE_INTERVAL]))
+        cg.add(var.set_energy_persist_interval(energy_conf[CONF_PERSIST_INTERVAL]))
+
+    if warm_start_conf := config.get(CONF_WARM_START):
+        cg.add(var.set_warm_start(warm_start_conf[CONF_PERSIST_INTERVAL]))
+
+    if clock_sync_conf := config.get(CONF_CLOCK_SYNC):
+        time_source = yield cg.get_variable(clock_sync_conf[CONF_TIME_ID])
+        cg.add(var.set_time_source(time_source))
+        cg.add(var.set_clock_sync_threshold(clock_sync_conf[CONF_THRESHOLD]))
+        cg.add(var.set_clock_sync_interval(clock_sync_conf[CONF_MIN_INTERVAL]))
+
     yield uart.register_uart_device(var, config)
@@ -0,0 +1,544 @@
+#pragma once
+
+// Balboa RS-485 protocol core: framing, CRC, message types and decoders.
+//
+// Header-only and free of ESPHome/Arduino dependencies so the same code runs
+// in BalboaSpa on the device and in host tools, benchmarks and tests.
+// Decoders return raw spa values (temperatures in the spa's own scale);
+// conversion and state tracking stay in the component.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace balboa_spa {
+namespace protocol {
+
+// Frame layout: 7E <len> <channel> <magic> <type> <payload...> <crc> 7E
+// <len> counts from itself to the CRC, so a frame is len + 2 bytes.
+constexpr uint8_t FRAME_DELIMITER = 0x7E;
+constexpr size_t MAX_FRAME_SIZE = 100;
+constexpr size_t MIN_FRAME_SIZE = 7;  // 7E len channel magic type crc 7E
+
+constexpr size_t OFFSET_LENGTH = 1;
+constexpr size_t OFFSET_CHANNEL = 2;
+constexpr size_t OFFSET_MAGIC = 3;
+constexpr size_t OFFSET_TYPE = 4;
+constexpr size_t OFFSET_PAYLOAD = 5;
+
+constexpr uint8_t CHANNEL_NEW_CLIENT = 0xFE;
+constexpr uint8_t CHANNEL_BROADCAST = 0xFF;
+constexpr uint8_t CHANNEL_MAX_CLIENT = 0x2F;
+
+constexpr uint8_t MAGIC_FROM_SPA = 0xAF;
+constexpr uint8_t MAGIC_TO_SPA = 0xBF;
+
+// Message types (byte 4)
+constexpr uint8_t MSG_NEW_CLIENT_CLEAR_TO_SEND = 0x00;
+constexpr uint8_t MSG_CHANNEL_ASSIGNMENT_REQUEST = 0x01;
+constexpr uint8_t MSG_CHANNEL_ASSIGNMENT = 0x02;
+constexpr uint8_t MSG_CHANNEL_ASSIGNMENT_ACK = 0x03;
+constexpr uint8_t MSG_CLEAR_TO_SEND = 0x06;
+constexpr uint8_t MSG_NOTHING_TO_SEND = 0x07;
+constexpr uint8_t MSG_TOGGLE_ITEM = 0x11;
+constexpr uint8_t MSG_STATUS = 0x13;
+constexpr uint8_t MSG_SET_TEMPERATURE = 0x20;
+constexpr uint8_t MSG_SET_TIME = 0x21;
+constexpr uint8_t MSG_SETTINGS_REQUEST = 0x22;
+constexpr uint8_t MSG_FILTER_CYCLES = 0x23;
+constexpr uint8_t MSG_INFORMATION = 0x24;
+constexpr uint8_t MSG_PREFERENCES = 0x26;
+constexpr uint8_t MSG_FAULT_LOG = 0x28;
+constexpr uint8_t MSG_CONFIGURATION = 0x2E;
+
+// Read-only view of a frame or payload
+struct ByteSpan {
+    const uint8_t *data;
+    size_t size;
+
+    constexpr uint8_t operator[](size_t index) const { return data[index]; }
+};
+
+// CRC-8, polynomial 0x07, init and final XOR 0x02, over <len> up to the last payload byte
+constexpr uint8_t crc8(const uint8_t *data, size_t length) {
+    uint8_t crc = 0x02;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc ^ 0x02;
+}
+
+// Accessors for a complete, validated frame
+inline uint8_t frame_channel(ByteSpan frame) { return frame[OFFSET_CHANNEL]; }
+inline uint8_t frame_type(ByteSpan frame) { return frame[OFFSET_TYPE]; }
+inline uint8_t frame_crc(ByteSpan frame) { return frame[frame[OFFSET_LENGTH]]; }
+
+// Smallest and largest length byte that can start a frame
+constexpr uint8_t MIN_LENGTH = MIN_FRAME_SIZE - 2;
+constexpr uint8_t MAX_LENGTH = MAX_FRAME_SIZE - 2;
+
+/**
+ * Byte-at-a-time frame assembler with a fixed buffer.
+ *
+ * Bytes outside a frame are dropped until a delimiter. A repeated delimiter
+ * (the end of one frame followed by the start of the next, seen when joining
+ * mid-stream) keeps a single start marker. A frame is complete when a
+ * delimiter arrives at the position announced by the length byte.
+ *
+ * A frame is rejected as soon as its length byte is implausible or the byte
+ * at its announced end is not a delimiter, and on a CRC mismatch. The parser
+ * then rescans the bytes it already holds for the next plausible "7E <len>"
+ * start instead of discarding them, so frames that arrived behind a corrupted
+ * one are still recovered. Recovered bytes can complete more than one frame,
+ * so after push() returns anything but NEED_MORE or DROPPED the caller should
+ * drain further results with poll() until it returns NEED_MORE.
+ */
+class FrameParser {
+  public:
+    enum Result : uint8_t {
+        DROPPED,       // byte outside a frame
+        NEED_MORE,     // byte buffered
+        FRAME,         // frame() holds a complete frame with a valid CRC
+        CRC_ERROR,     // complete frame, CRC mismatch; buffered bytes rescanned
+        LENGTH_ERROR,  // length byte does not match the frame or the buffer; buffered bytes rescanned
+    };
+
+    struct Stats {
+        uint32_t frames = 0;
+        uint32_t crc_errors = 0;
+        uint32_t length_errors = 0;  // oversized + undersized + truncated
+        uint32_t oversized = 0;      // length byte beyond the buffer
+        uint32_t undersized = 0;     // length byte too small for a frame
+        uint32_t truncated = 0;      // no delimiter where the length byte said the frame ends
+        uint32_t bytes_dropped = 0;  // outside any frame, e.g. line idle noise
+        uint32_t bytes_lost = 0;     // discarded while resynchronizing after an error
+    };
+
+    Result push(uint8_t byte) {
+        release_frame();
+        if (size_ == 0 && byte != FRAME_DELIMITER) {
+            stats_.bytes_dropped++;
+            return DROPPED;
+        }
+        buffer_[size_++] = byte;
+        return poll();
+    }
+
+    // Evaluates the buffered bytes without adding one; returns NEED_MORE when nothing is left to report
+    Result poll() {
+        release_frame();
+        for (;;) {
+            if (size_ < 2) {
+                return NEED_MORE;
+            }
+            if (buffer_[OFFSET_LENGTH] == FRAME_DELIMITER) {
+                discard(1, false);  // double delimiter, keep one
+                continue;
+            }
+            uint8_t length = buffer_[OFFSET_LENGTH];
+            if (length < MIN_LENGTH || length > MAX_LENGTH) {
+                stats_.length_errors++;
+                if (length > MAX_LENGTH) {
+                    stats_.oversized++;
+                } else {
+                    stats_.undersized++;
+                }
+                resync();
+                return LENGTH_ERROR;
+            }
+            size_t frame_size = static_cast<size_t>(length) + 2;
+            if (size_ < frame_size) {
+                return NEED_MORE;
+            }
+            if (buffer_[frame_size - 1] != FRAME_DELIMITER) {
+                stats_.length_errors++;
+                stats_.truncated++;
+                resync();
+                return LENGTH_ERROR;
+            }
+            if (crc8(buffer_ + OFFSET_LENGTH, length - 1) != buffer_[length]) {
+                stats_.crc_errors++;
+                resync();
+                return CRC_ERROR;
+            }
+            frame_size_ = frame_size;
+            stats_.frames++;
+            return FRAME;
+        }
+    }
+
+    // Valid after push() or poll() returned FRAME, until the next push() or poll()
+    ByteSpan frame() const { return {buffer_, frame_size_}; }
+    size_t buffered() const { return size_; }
+    const Stats &stats() const { return stats_; }
+    void reset() {
+        size_ = 0;
+        frame_size_ = 0;
+    }
+
+  private:
+    void release_frame() {
+        if (frame_size_ != 0) {
+            discard(frame_size_, false);
+            frame_size_ = 0;
+        }
+    }
+
+    // Drops the rejected start delimiter and everything up to the next plausible frame start
+    void resync() {
+        size_t next = 1;
+        while (next < size_) {
+            if (buffer_[next] == FRAME_DELIMITER) {
+                if (next + 1 == size_) break;
+                uint8_t length = buffer_[next + 1];
+                if (length == FRAME_DELIMITER || (length >= MIN_LENGTH && length <= MAX_LENGTH)) break;
+            }
+            next++;
+        }
+        discard(next, true);
+    }
+
+    void discard(size_t count, bool lost) {
+        if (lost) {
+            stats_.bytes_lost += count;
+        }
+        for (size_t i = count; i < size_; i++) {
+            buffer_[i - count] = buffer_[i];
+        }
+        size_ -= count;
+    }
+
+    uint8_t buffer_[MAX_FRAME_SIZE];
+    size_t size_ = 0;
+    size_t frame_size_ = 0;
+    Stats stats_;
+};
+
+/**
+ * Wraps a message (channel, magic, type, data) into a full frame.
+ * Returns the number of bytes written to out, or 0 if capacity is too small.
+ */
+inline size_t encode_frame(const uint8_t *message, size_t message_size, uint8_t *out, size_t capacity) {
+    size_t frame_size = message_size + 4;
+    if (frame_size > capacity || message_size + 2 > 0xFF) {
+        return 0;
+    }
+    out[0] = FRAME_DELIMITER;
+    out[1] = static_cast<uint8_t>(message_size + 2);
+    for (size_t i = 0; i < message_size; i++) {
+        out[2 + i] = message[i];
+    }
+    out[frame_size - 2] = crc8(out + 1, message_size + 1);
+    out[frame_size - 1] = FRAME_DELIMITER;
+    return frame_size;
+}
+
+/**
+ * Same as encode_frame() for a message held in a queue (anything with size()
+ * and operator[], e.g. BalboaSpa's output_queue), copied straight into out.
+ */
+template<typename Queue> size_t encode_queued_frame(Queue &queue, uint8_t *out, size_t capacity) {
+    size_t message_size = queue.size();
+    size_t frame_size = message_size + 4;
+    if (frame_size > capacity || message_size + 2 > 0xFF) {
+        return 0;
+    }
+    out[0] = FRAME_DELIMITER;
+    out[1] = static_cast<uint8_t>(message_size + 2);
+    for (size_t i = 0; i < message_size; i++) {
+        out[2 + i] = queue[i];
+    }
+    out[frame_size - 2] = crc8(out + 1, message_size + 1);
+    out[frame_size - 1] = FRAME_DELIMITER;
+    return frame_size;
+}
+
+// Payload limits per message type, checked before a frame is decoded; other types are not checked.
+// Minimums are what the decoders read; maximums leave room for longer variants seen across boards.
+struct PayloadLimits {
+    uint8_t type;
+    uint8_t min_size;
+    uint8_t max_size;
+};
+
+constexpr PayloadLimits PAYLOAD_LIMITS[] = {
+    {MSG_NEW_CLIENT_CLEAR_TO_SEND, 0, 0},
+    {MSG_CHANNEL_ASSIGNMENT_REQUEST, 1, 3},  // device type and a 16-bit hash, e.g. 02 F1 73
+    {MSG_CHANNEL_ASSIGNMENT, 1, 3},
+    {MSG_CHANNEL_ASSIGNMENT_ACK, 0, 0},
+    {MSG_CLEAR_TO_SEND, 0, 0},
+    {MSG_NOTHING_TO_SEND, 0, 0},
+    {MSG_TOGGLE_ITEM, 2, 2},
+    {MSG_STATUS, 21, 40},
+    {MSG_SET_TEMPERATURE, 1, 1},
+    {MSG_SET_TIME, 2, 2},
+    {MSG_SETTINGS_REQUEST, 3, 3},
+    {MSG_FILTER_CYCLES, 8, 12},
+    {MSG_INFORMATION, 21, 30},
+    {MSG_PREFERENCES, 9, 20},
+    {MSG_FAULT_LOG, 6, 16},
+    {MSG_CONFIGURATION, 5, 12},
+};
+
+enum SizeCheck : uint8_t { SIZE_OK, SIZE_TOO_SHORT, SIZE_TOO_LONG };
+
+inline SizeCheck check_payload_size(ByteSpan frame) {
+    size_t payload = frame.size - MIN_FRAME_SIZE;
+    for (const auto &limits : PAYLOAD_LIMITS) {
+        if (limits.type == frame_type(frame)) {
+            if (payload < limits.min_size) return SIZE_TOO_SHORT;
+            if (payload > limits.max_size) return SIZE_TOO_LONG;
+            return SIZE_OK;
+        }
+    }
+    return SIZE_OK;
+}
+
+// FF AF 13: status update, broadcast several times a second
+struct StatusMessage {
+    uint8_t current_temp;   // spa scale, 0xFF when unknown
+    uint8_t target_temp;    // spa scale
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t rest_mode;
+    uint8_t heat_state;
+    uint8_t high_range;
+    uint8_t pumps[6];       // 0 off, 1 low, 2 high (one-speed pumps report 2)
+    uint8_t circulation;
+    uint8_t blower;
+    uint8_t light1;
+    uint8_t light2;
+    uint8_t mister;
+    uint8_t aux1;
+    uint8_t aux2;
+};
+
+constexpr size_t STATUS_MIN_FRAME_SIZE = 28;
+
+inline bool decode_status(ByteSpan frame, StatusMessage &out) {
+    if (frame.size < STATUS_MIN_FRAME_SIZE) {
+        return false;
+    }
+    out.current_temp = frame[7];
+    out.hour = frame[8];
+    out.minute = frame[9];
+    out.rest_mode = frame[10];
+    out.heat_state = (frame[15] >> 4) & 0x01;
+    out.high_range = (frame[15] >> 2) & 0x01;
+    out.pumps[0] = frame[16] & 0x03;
+    out.pumps[1] = (frame[16] >> 2) & 0x03;
+    out.pumps[2] = (frame[16] >> 4) & 0x03;
+    out.pumps[3] = (frame[16] >> 6) & 0x03;
+    out.pumps[4] = frame[17] & 0x03;
+    out.pumps[5] = (frame[17] >> 2) & 0x03;
+    out.circulation = (frame[18] >> 1) & 0x01;
+    out.blower = (frame[18] >> 2) & 0x01;
+    out.light1 = frame[19] == 0x03;
+    out.light2 = ((frame[19] >> 2) & 0x03) == 0x03;
+    out.mister = frame[20] & 0x01;
+    out.aux1 = (frame[20] >> 3) & 0x01;
+    out.aux2 = (frame[20] >> 4) & 0x01;
+    out.target_temp = frame[25];
+    return true;
+}
+
+// <id> AF 2E: configuration response
+struct ConfigMessage {
+    uint8_t pumps[6];  // 0 absent, 1 one-speed, 2 two-speed
+    uint8_t light1;
+    uint8_t light2;
+    uint8_t circulation;
+    uint8_t blower;
+    uint8_t mister;
+    uint8_t aux1;
+    uint8_t aux2;
+    uint8_t temperature_scale;
+};
+
+constexpr size_t CONFIG_MIN_FRAME_SIZE = 12;
+
+inline bool decode_config(ByteSpan frame, ConfigMessage &out) {
+    if (frame.size < CONFIG_MIN_FRAME_SIZE) {
+        return false;
+    }
+    out.pumps[0] = frame[5] & 0x03;
+    out.pumps[1] = (frame[5] >> 2) & 0x03;
+    out.pumps[2] = (frame[5] >> 4) & 0x03;
+    out.pumps[3] = (frame[5] >> 6) & 0x03;
+    out.pumps[4] = frame[6] & 0x03;
+    out.pumps[5] = (frame[6] >> 6) & 0x03;
+    out.light1 = frame[7] & 0x03;
+    out.light2 = (frame[7] >> 2) & 0x03;
+    out.circulation = (frame[8] & 0x80) != 0;
+    out.blower = (frame[8] & 0x03) != 0;
+    out.mister = (frame[9] & 0x30) != 0;
+    out.aux1 = (frame[9] & 0x01) != 0;
+    out.aux2 = (frame[9] & 0x02) != 0;
+    out.temperature_scale = frame[3] & 0x01;
+    return true;
+}
+
+// <id> AF 23: filter cycle schedule
+struct FilterCyclesMessage {
+    uint8_t filter1_hour;
+    uint8_t filter1_minute;
+    uint8_t filter1_duration_hour;
+    uint8_t filter1_duration_minute;
+    uint8_t filter2_enable;
+    uint8_t filter2_hour;
+    uint8_t filter2_minute;
+    uint8_t filter2_duration_hour;
+    uint8_t filter2_duration_minute;
+};
+
+constexpr size_t FILTER_CYCLES_MIN_FRAME_SIZE = 15;
+
+inline bool decode_filter_cycles(ByteSpan frame, FilterCyclesMessage &out) {
+    if (frame.size < FILTER_CYCLES_MIN_FRAME_SIZE) {
+        return false;
+    }
+    out.filter1_hour = frame[5];
+    out.filter1_minute = frame[6];
+    out.filter1_duration_hour = frame[7];
+    out.filter1_duration_minute = frame[8];
+    out.filter2_enable = (frame[9] >> 7) & 0x01;
+    out.filter2_hour = frame[9] & 0x1F;
+    out.filter2_minute = frame[10];
+    out.filter2_duration_hour = frame[11];
+    out.filter2_duration_minute = frame[12];
+    return true;
+}
+
+// True while the spa clock is inside a filter cycle; a cycle may run past midnight
+inline bool filter_cycle_active(uint8_t start_hour, uint8_t start_minute, uint8_t duration_hour,
+                                uint8_t duration_minute, uint8_t hour, uint8_t minute) {
+    constexpr uint32_t minutes_per_day = 24 * 60;
+    uint32_t duration = duration_hour * 60 + duration_minute;
+    if (duration == 0) {
+        return false;
+    }
+    uint32_t now = hour * 60 + minute;
+    uint32_t start = start_hour * 60 + start_minute;
+    uint32_t end = start + duration;
+    if (end > minutes_per_day) {
+        return now >= start || now < end - minutes_per_day;
+    }
+    return now >= start && now < end;
+}
+
+// <id> AF 24: system information, the answer to settings request 02 00 00
+struct InformationMessage {
+    uint8_t software_id[4];  // shown as M<0>_<1> V<2>.<3>
+    char model[9];           // ASCII, trailing spaces removed
+    uint8_t setup;
+    uint8_t heater_voltage;  // 1 is 240 V
+    uint8_t heater_type;
+    uint16_t dip_switches;
+};
+
+constexpr size_t INFORMATION_MIN_FRAME_SIZE = 28;
+
+inline bool decode_information(ByteSpan frame, InformationMessage &out) {
+    if (frame.size < INFORMATION_MIN_FRAME_SIZE) {
+        return false;
+    }
+    for (size_t i = 0; i < 4; i++) {
+        out.software_id[i] = frame[5 + i];
+    }
+    size_t length = 0;
+    for (size_t i = 0; i < 8; i++) {
+        uint8_t c = frame[9 + i];
+        out.model[i] = (c >= 0x20 && c < 0x7F) ? static_cast<char>(c) : '?';
+        if (c != ' ') {
+            length = i + 1;
+        }
+    }
+    out.model[length] = '\0';
+    out.setup = frame[17];
+    out.heater_voltage = frame[22];
+    out.heater_type = frame[23];
+    out.dip_switches = static_cast<uint16_t>(frame[24] << 8 | frame[25]);
+    return true;
+}
+
+// <id> AF 26: panel preferences, the answer to settings request 08 00 00
+struct PreferencesMessage {
+    uint8_t reminders;
+    uint8_t temperature_scale;  // 0 Fahrenheit, 1 Celsius
+    uint8_t clock_24h;
+    uint8_t cleanup_cycle;      // half hours, 0 off
+    uint8_t dolphin_address;
+    uint8_t m8_ai;
+};
+
+constexpr size_t PREFERENCES_MIN_FRAME_SIZE = 16;
+
+inline bool decode_preferences(ByteSpan frame, PreferencesMessage &out) {
+    if (frame.size < PREFERENCES_MIN_FRAME_SIZE) {
+        return false;
+    }
+    out.reminders = frame[6];
+    out.temperature_scale = frame[8];
+    out.clock_24h = frame[9];
+    out.cleanup_cycle = frame[10];
+    out.dolphin_address = frame[11];
+    out.m8_ai = frame[13];
+    return true;
+}
+
+// <id> AF 28: one fault log entry
+struct FaultLogMessage {
+    uint8_t total_entries;
+    uint8_t current_entry;
+    uint8_t fault_code;
+    uint8_t days_ago;
+    uint8_t hour;
+    uint8_t minute;
+};
+
+constexpr size_t FAULT_LOG_MIN_FRAME_SIZE = 13;
+
+inline bool decode_fault_log(ByteSpan frame, FaultLogMessage &out) {
+    if (frame.size < FAULT_LOG_MIN_FRAME_SIZE) {
+        return false;
+    }
+    out.total_entries = frame[5];
+    out.current_entry = frame[6];
+    out.fault_code = frame[7];
+    out.days_ago = frame[8];
+    out.hour = frame[9];
+    out.minute = frame[10];
+    return true;
+}
+
+inline const char *fault_message(uint8_t code) {
+    switch (code) {
+        case 15: return "Sensors are out of sync";
+        case 16: return "The water flow is low";
+        case 17: return "The water flow has failed";
+        case 18: return "The settings have been reset";
+        case 19: return "Priming Mode";
+        case 20: return "The clock has failed";
+        case 21: return "The settings have been reset";
+        case 22: return "Program memory failure";
+        case 26: return "Sensors are out of sync -- Call for service";
+        case 27: return "The heater is dry";
+        case 28: return "The heater may be dry";
+        case 29: return "The water is too hot";
+        case 30: return "The heater is too hot";
+        case 31: return "Sensor A Fault";
+        case 32: return "Sensor B Fault";
+        case 34: return "A pump may be stuck on";
+        case 35: return "Hot fault";
+        case 36: return "The GFCI test failed";
+        case 37: return "Standby Mode (Hold Mode)";
+        default: return "Unknown error";
+    }
+}
+
+}  // namespace protocol
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -9,24 +9,60 @@ static const char *TAG = "BalboaSpa.component";
 static const uint32_t COMMUNICATION_TIMEOUT_MS = 10000;
 static const uint32_t FILTER_SETTINGS_REQUEST_INTERVAL_MS = 60000;
 static const uint32_t MINUTES_PER_DAY = 1440;
+static const uint32_t MS_PER_DAY = 86400000;
+static const uint32_t FILTER_COUNTERS_PREF_VERSION = 2;  // bump when SpaFilterCounters changes layout
+static const uint32_t HISTORY_SAMPLE_INTERVAL_MS = 1000;
+static const uint32_t ENERGY_INTEGRATION_INTERVAL_MS = 1000;
+static const uint32_t ENERGY_COUNTERS_PREF_VERSION = 2;  // bump when SpaEnergyCounters changes layout
+static const uint16_t HISTORY_EVENT_CHUNK_MINUTES = 60;  // minutes per Home Assistant event, bounds the payload size
+static const uint32_t BUS_TIMING_LOG_INTERVAL_MS = 600000;
+static const uint32_t WARM_START_PREF_VERSION = 1;  // bump when SpaWarmStart changes layout
+static const uint32_t WARM_START_ID_TIMEOUT_MS = 10000;  // a restored client ID must see a clear-to-send within this
+static const uint8_t ECHO_SILENT_SENDS_WARNING = 5;  // sends without any echo byte before suggesting echo_check is off
+static const float TURNAROUND_SMOOTHING = 0.125f;  // weight of the newest frame in the turnaround average
 
 void BalboaSpa::setup() {
-    input_queue.clear();
+    if (flow_control_pin != nullptr) {
+        flow_control_pin->setup();
+        flow_control_pin->digital_write(false);
+    }
+    parser.reset();
+    refresh_scheduler.set_max_per_poll(ESPHOME_BALBOASPA_MAX_REFRESHES_PER_POLL);
     output_queue.clear();
+    uint32_t bits_per_byte = 1 + parent_->get_data_bits() + parent_->get_stop_bits();
+    bus_timing.set_byte_time_us(bits_per_byte * 1e6f / parent_->get_baud_rate());
     // Initialize state tracking
     last_received_time = 0;
     last_filtersettings_request = 0;
     client_id = 0;
     send_command = 0x00;
-    config_request_status = 0;
-    faultlog_request_status = 0;
-    filtersettings_request_status = 0;
+    discovery.restart();
     last_state_crc = 0;
+
+    restore_filter_counters();
+    restore_energy_counters();
+    restore_warm_start();
+
+    if (history_hours > 0) {
+        history.allocate(history_hours * 60);
+        ESP_LOGD(TAG, "Keeping %d hours of history", history_hours);
+    }
+#ifdef USE_API
+    register_service(&BalboaSpa::on_history_request, "get_spa_history", {"minutes"});
+#endif
     
     // Debug temperature scale initialization
     ESP_LOGD(TAG, "Setup - Initial spa_temp_scale: %d, esphome_temp_scale: %d", spa_temp_scale, esphome_temp_scale);
 }
 
+void BalboaSpa::loop() {
+    // Drained every loop rather than every poll so frame timestamps and CTS replies are not held back
+    while (available()) {
+      read_serial();
+    }
+    check_echo_timeout();
+}
+
 void BalboaSpa::update() {
     uint32_t now = millis();
     
@@ -35,40 +71,236 @@ void BalboaSpa::update() {
         ESP_LOGW(TAG, "No communication for %d seconds - marking as dead!", (now - last_received_time) / 1000);
         status_set_error("No Communication with Balboa Mainboard!");
         client_id = 0;
+        client_id_restored = false;
     } else if (status_has_error()) {
         status_clear_error();
     }
 
-    // Optimized periodic filter settings request
+    if (client_id_restored && now > WARM_START_ID_TIMEOUT_MS) {
+        // The mainboard forgot us or gave the ID away; negotiate a new one
+        ESP_LOGI(TAG, "Restored client ID %d was not polled, requesting a new one", client_id);
+        client_id = 0;
+        client_id_restored = false;
+    }
+    if (warm_start && (warm_start_identity_dirty || now - last_warm_start_save >= warm_start_persist_interval)) {
+        save_warm_start(now, false);
+    }
+
+    // Periodic filter settings request, sent at the next clear-to-send
     if (now - last_filtersettings_request > FILTER_SETTINGS_REQUEST_INTERVAL_MS) {
-        if (client_id != 0) {
-            output_queue.push(client_id);
-            output_queue.push(0xBF);
-            output_queue.push(0x22);
-            output_queue.push(0x01);
-            output_queue.push(0x00);
-            output_queue.push(0x00);
-            ESP_LOGD(TAG, "Requesting filter settings (periodic)");
-            rs485_send();
-        }
+        discovery.refresh(SpaDiscovery::FILTER_CYCLES);
         last_filtersettings_request = now;
     }
 
-    // Process available serial data
-    while (available()) {
-      read_serial();
+    save_filter_counters(false);
+    update_energy(now);
+#ifdef USE_TIME
+    sync_clock(now);
+#endif
+
+    if (now - last_bus_timing_log >= BUS_TIMING_LOG_INTERVAL_MS) {
+        last_bus_timing_log = now;
+        log_bus_timing();
+    }
+
+    if (history.enabled() && now - last_history_sample >= HISTORY_SAMPLE_INTERVAL_MS) {
+        last_history_sample = now;
+        sample_history(now);
     }
 
     // Run through listeners with null check
     if (!this->listeners_.empty()) {
       for (const auto &listener : this->listeners_) {
-        if (listener) {
-          listener(&spaState);
+        if (listener.callback && has_equipment(listener.equipment)) {
+          listener.callback(&spaState);
         }
       }
     }
+
+    refresh_scheduler.run(now);
+}
+
+void BalboaSpa::dump_config() {
+    ESP_LOGCONFIG(TAG, "Balboa Spa:");
+    ESP_LOGCONFIG(TAG, "  Spa temperature scale: %d", spa_temp_scale);
+    ESP_LOGCONFIG(TAG, "  ESPHome temperature scale: %d", esphome_temp_scale);
+    ESP_LOGCONFIG(TAG, "  Listeners: %u", (unsigned) listeners_.size());
+    ESP_LOGCONFIG(TAG, "  Filter counter persist interval: %u min", (unsigned) (filter_persist_interval / 60000));
+    ESP_LOGCONFIG(TAG, "  History: %u minutes", (unsigned) history.capacity());
+    ESP_LOGCONFIG(TAG, "  Energy metering: %s", energy_meter.enabled() ? "YES" : "NO");
+    ESP_LOGCONFIG(TAG, "  Toggle retries: %d", toggle_retries);
+    ESP_LOGCONFIG(TAG, "  Write confirmation: %d status frames, %d retries", write_confirm_frames, write_retries);
+    ESP_LOGCONFIG(TAG, "  Echo check: %s", echo_check.enabled() ? "YES" : "NO");
+    ESP_LOGCONFIG(TAG, "  Warm start: %s", warm_start ? "YES" : "NO");
+    ESP_LOGCONFIG(TAG, "  Publish-limited entities: %u", (unsigned) publish_limiter.size());
+    ESP_LOGCONFIG(TAG, "  Refresh: %u entities every %u s", (unsigned) refresh_scheduler.size(),
+                  (unsigned) (refresh_scheduler.interval() / 1000));
+    LOG_PIN("  Flow control pin: ", flow_control_pin);
+#ifdef USE_TIME
+    ESP_LOGCONFIG(TAG, "  Clock sync: %s", time_source != nullptr ? "YES" : "NO");
+#endif
+    log_memory_footprint();
+}
+
+void BalboaSpa::log_memory_footprint() {
+    struct MemoryItem {
+        const char *name;
+        size_t bytes;
+    };
+
+    // Fixed-size members, all included in sizeof(BalboaSpa)
+    ESP_LOGCONFIG(TAG, "  Memory footprint (bytes):");
+    ESP_LOGCONFIG(TAG, "    BalboaSpa object:   %u", (unsigned) sizeof(BalboaSpa));
+    ESP_LOGCONFIG(TAG, "      SpaState:         %u", (unsigned) sizeof(SpaState));
+    ESP_LOGCONFIG(TAG, "      SpaConfig:        %u", (unsigned) sizeof(SpaConfig));
+    ESP_LOGCONFIG(TAG, "      SpaFaultLog:      %u", (unsigned) sizeof(SpaFaultLog));
+    ESP_LOGCONFIG(TAG, "      SpaFilterSettings: %u", (unsigned) sizeof(SpaFilterSettings));
+    ESP_LOGCONFIG(TAG, "      FrameParser:      %u", (unsigned) sizeof(parser));
+    ESP_LOGCONFIG(TAG, "      CircularBuffer:   %u", (unsigned) sizeof(output_queue));
+
+    // Heap owned by the component and its entities
+    const size_t listener_bytes = listeners_.capacity() * sizeof(SpaListener);
+    MemoryItem items[] = {
+        {"BalboaSpa object", sizeof(BalboaSpa)},
+        {"output_queue heap", output_queue.heap_bytes()},
+        {"listener slots", listener_bytes},
+        {"publish limits", publish_limiter.heap_bytes()},
+        {"refresh slots", refresh_scheduler.heap_bytes()},
+        {"entity objects", entity_bytes_},
+        {"fault message", spaFaultLog.fault_message.capacity()},
+        {"history", history.heap_bytes()},
+    };
+    std::sort(std::begin(items), std::end(items), [](const MemoryItem &a, const MemoryItem &b) { return a.bytes > b.bytes; });
+
+    size_t total = 0;
+    for (const auto &item : items) {
+        total += item.bytes;
+    }
+    ESP_LOGCONFIG(TAG, "  Top contributors (approx. %u bytes total):", (unsigned) total);
+    for (const auto &item : items) {
+        ESP_LOGCONFIG(TAG, "    %-18s %6u", item.name, (unsigned) item.bytes);
+    }
+    if (!listeners_.empty()) {
+        ESP_LOGCONFIG(TAG, "    per entity avg     %6u", (unsigned) ((listener_bytes + entity_bytes_) / listeners_.size()));
+    }
+}
+
+void BalboaSpa::restore_energy_counters() {
+    if (!energy_meter.enabled()) {
+        return;
+    }
+    energy_pref = global_preferences->make_preference<SpaEnergyCounters>(
+        fnv1_hash("balboa_spa_energy_counters") + ENERGY_COUNTERS_PREF_VERSION, true);
+    if (energy_pref.load(&energy_meter.counters())) {
+        ESP_LOGD(TAG, "Restored energy counters");
+    }
+    energy_meter.take_snapshot();
 }
 
+void BalboaSpa::update_energy(uint32_t now) {
+    if (!energy_meter.enabled()) {
+        return;
+    }
+    uint32_t elapsed = now - last_energy_tick;
+    if (elapsed < ENERGY_INTEGRATION_INTERVAL_MS) {
+        return;
+    }
+    // Only integrate time covered by live status frames, not a warm-started state
+    if (is_communicating() && first_state_ms != 0 && last_energy_tick != 0) {
+        energy_meter.observe_clock(spaState.hour);
+        energy_meter.integrate(elapsed, spaState);
+        energy_dirty = true;
+    }
+    last_energy_tick = now;
+
+    if (now - last_energy_snapshot >= energy_update_interval) {
+        energy_meter.take_snapshot();
+        last_energy_snapshot = now;
+    }
+
+    save_energy_counters(now, false);
+}
+
+void BalboaSpa::save_energy_counters(uint32_t now, bool force) {
+    if (!energy_meter.enabled() || !energy_dirty) {
+        return;
+    }
+    // Unless forced, coalesce changes so there is at most one write per persist interval
+    if (!force && now - last_energy_save < energy_persist_interval) {
+        return;
+    }
+    if (energy_pref.save(&energy_meter.counters())) {
+        energy_dirty = false;
+        last_energy_save = now;
+        ESP_LOGD(TAG, "Stored energy counters");
+    } else {
+        ESP_LOGW(TAG, "Failed to store energy counters");
+    }
+}
+
+void BalboaSpa::sample_history(uint32_t now) {
+    // A warm-started state is not recorded until a live status frame confirms it
+    if (!is_communicating() || first_state_ms == 0) {
+        return;
+    }
+
+    uint8_t temp_half_c = SpaHistory::NO_SAMPLE;
+    if (!std::isnan(spaState.current_temp)) {
+        float temp_c = esphome_temp_scale == TEMP_SCALE::F ? convert_f_to_c(spaState.current_temp) : spaState.current_temp;
+        temp_half_c = static_cast<uint8_t>(std::lround(temp_c * 2));
+    }
+
+    uint16_t loads = 0;
+    if (spaState.pump1) loads |= HISTORY_LOAD_PUMP1;
+    if (spaState.pump2) loads |= HISTORY_LOAD_PUMP2;
+    if (spaState.pump3) loads |= HISTORY_LOAD_PUMP3;
+    if (spaState.pump4) loads |= HISTORY_LOAD_PUMP4;
+    if (spaState.pump5) loads |= HISTORY_LOAD_PUMP5;
+    if (spaState.pump6) loads |= HISTORY_LOAD_PUMP6;
+    if (spaState.blower) loads |= HISTORY_LOAD_BLOWER;
+    if (spaState.circulation) loads |= HISTORY_LOAD_CIRCULATION;
+    if (spaState.light) loads |= HISTORY_LOAD_LIGHT;
+
+    history.sample(now, temp_half_c, spaState.heat_state == 1, loads);
+}
+
+#ifdef USE_API
+// Sends the requested history to Home Assistant as esphome.balboa_spa_history events,
+// one per HISTORY_EVENT_CHUNK_MINUTES, oldest first. Each field is a comma separated
+// list; temperatures are half degrees Celsius and 255 marks a minute without data.
+void BalboaSpa::on_history_request(int minutes) {
+    if (!history.enabled()) {
+        ESP_LOGW(TAG, "History requested but history_hours is not configured");
+        return;
+    }
+    uint16_t available = history.size();
+    uint16_t requested = minutes <= 0 || minutes > available ? available : minutes;
+    uint16_t first = available - requested;
+
+    for (uint16_t chunk_start = first; chunk_start < available; chunk_start += HISTORY_EVENT_CHUNK_MINUTES) {
+        uint16_t chunk_end = std::min<uint16_t>(chunk_start + HISTORY_EVENT_CHUNK_MINUTES, available);
+        std::string tmin, tmax, tavg, heat, loads;
+        for (uint16_t i = chunk_start; i < chunk_end; i++) {
+            const char *sep = i == chunk_start ? "" : ",";
+            tmin += sep + std::to_string(history.temp_min(i));
+            tmax += sep + std::to_string(history.temp_max(i));
+            tavg += sep + std::to_string(history.temp_avg(i));
+            heat += sep + std::to_string(history.heat_percent(i));
+            loads += sep + std::to_string(history.loads(i));
+        }
+        fire_homeassistant_event("esphome.balboa_spa_history", {
+            {"minutes_ago", std::to_string(available - chunk_start)},
+            {"count", std::to_string(chunk_end - chunk_start)},
+            {"temp_min", tmin},
+            {"temp_max", tmax},
+            {"temp_avg", tavg},
+            {"heat_percent", heat},
+            {"loads", loads},
+        });
+    }
+}
+#endif
+
 float BalboaSpa::get_setup_priority() const { return esphome::setup_priority::LATE; }
 
 SpaConfig BalboaSpa::get_current_config() { return spaConfig; }
@@ -98,6 +330,7 @@ void BalboaSpa::set_temp(float temp) {
     }
 
     // Set target temperature based on spa scale
+    uint8_t target_temperature;
     if (spa_temp_scale == TEMP_SCALE::C) {
         target_temperature = target_temp * 2;
     } else if (spa_temp_scale == TEMP_SCALE::F) {
@@ -107,20 +340,63 @@ void BalboaSpa::set_temp(float temp) {
         return;
     }
 
-    send_command = 0xff;
+    // Sent at the next clear-to-send and resent until a status frame shows it
+    temperature_write.request(target_temperature);
 }
 
-void BalboaSpa::set_highrange(bool high) {
-    if (high != spaState.highrange) {
-        ESP_LOGD(TAG, "Setting highrange: %d -> %d", spaState.highrange, high);
-        send_command = 0x50;
+void BalboaSpa::set_time(int hour, int minute) {
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+        ESP_LOGW(TAG, "Invalid time: %d:%02d", hour, minute);
+        return;
+    }
+    // One BF 21 carries both, so hour and minute cannot race
+    request_clock(hour * 60 + minute, false);
+}
+
+void BalboaSpa::request_clock(uint16_t minute_of_day, bool exact) {
+    clock_write.request(minute_of_day);
+    clock_write_exact = exact;
+}
+
+#ifdef USE_TIME
+void BalboaSpa::observe_spa_clock_tick(uint8_t hour, uint8_t minute) {
+    if (time_source == nullptr) {
+        return;
+    }
+    ESPTime real = time_source->now();
+    if (!real.is_valid()) {
+        return;
     }
+    clock_sync.observe_tick(hour * 60 + minute, real.hour * 3600 + real.minute * 60 + real.second, real.timestamp);
+    ESP_LOGV(TAG, "Spa clock error %.0f s, drift %.1f s/day", clock_sync.error_seconds(), clock_sync.drift_seconds_per_day());
+}
+
+void BalboaSpa::sync_clock(uint32_t now) {
+    if (time_source == nullptr || !is_communicating() || clock_write.pending() || !clock_sync.sync_due(now)) {
+        return;
+    }
+    ESPTime real = time_source->now();
+    // Set at the top of a real minute so the spa's seconds start in step
+    if (!real.is_valid() || real.second > 2) {
+        return;
+    }
+    ESP_LOGI(TAG, "Spa clock is off by %.0f s, setting it to %02d:%02d", clock_sync.error_seconds(), real.hour, real.minute);
+    request_clock(real.hour * 60 + real.minute, true);
+    clock_sync.synced(now);
+}
+#endif
+
+void BalboaSpa::set_highrange(bool high) {
+    ESP_LOGD(TAG, "Setting highrange: %d -> %d", spaState.highrange, high);
+    // Toggle-only like the pumps, so a lost or doubled toggle must not leave the preset wrong
+    set_item_state(TOGGLE_ITEM_HIGH_RANGE, high);
 }
 
 void BalboaSpa::set_hour(int hour) {
     if (hour >= 0 && hour <= 23) {
-        target_hour = hour;
-        send_command = 0x21;
+        // Keep a minute set just before, otherwise the spa's own current minute
+        uint8_t minute = clock_write.pending() ? clock_write.value() % 60 : spaState.minutes;
+        request_clock(hour * 60 + minute, false);
     } else {
         ESP_LOGW(TAG, "Invalid hour: %d", hour);
     }
@@ -128,35 +404,48 @@ void BalboaSpa::set_hour(int hour) {
 
 void BalboaSpa::set_minute(int minute) {
     if (minute >= 0 && minute <= 59) {
-        target_minute = minute;
-        send_command = 0x21;
+        uint8_t hour = clock_write.pending() ? clock_write.value() / 60 : spaState.hour;
+        request_clock(hour * 60 + minute, false);
     } else {
         ESP_LOGW(TAG, "Invalid minute: %d", minute);
     }
 }
 
+void BalboaSpa::toggle_item(uint8_t item) {
+    // A raw toggle would fight the reconciler, so this asks it for the opposite of the expected state
+    set_item_state(item, !toggle_reconciler.wants_on(item, spaState));
+}
+
+void BalboaSpa::set_item_state(uint8_t item, bool on) {
+    set_item_level(item, on ? ToggleReconciler::LEVEL_ON : 0);
+}
+
+void BalboaSpa::set_item_level(uint8_t item, uint8_t level) {
+    toggle_reconciler.request(item, level, millis());
+}
+
 void BalboaSpa::toggle_light() {
-    send_command = 0x11;
+    toggle_item(TOGGLE_ITEM_LIGHT1);
 }
 
 void BalboaSpa::toggle_jet1() {
-    send_command = 0x04;
+    toggle_item(TOGGLE_ITEM_PUMP1);
 }
 
 void BalboaSpa::toggle_jet2() {
-    send_command = 0x05;
+    toggle_item(TOGGLE_ITEM_PUMP2);
 }
 
 void BalboaSpa::toggle_jet3() {
-    send_command = 0x06;
+    toggle_item(TOGGLE_ITEM_PUMP3);
 }
 
 void BalboaSpa::toggle_jet4() {
-    send_command = 0x07;
+    toggle_item(TOGGLE_ITEM_PUMP4);
 }
 
 void BalboaSpa::toggle_blower() {
-    send_command = 0x0C;
+    toggle_item(TOGGLE_ITEM_BLOWER);
 }
 
 void BalboaSpa::read_serial() {
@@ -164,169 +453,193 @@ void BalboaSpa::read_serial() {
         return;
     }
 
-    // Drop until SOF is seen
-    if (input_queue.first() != 0x7E && received_byte != 0x7E) {
-        input_queue.clear();
-        return;
+    // Our own echo never reaches the parser, so collisions do not count as CRC errors
+    auto echo = echo_check.on_byte(received_byte);
+    if (echo == EchoCheck::COLLISION) {
+        ESP_LOGD(TAG, "Collision: echo did not match the sent frame%s",
+                 echo_check.retransmit_due() ? ", resending at next clear-to-send" : "");
     }
-
-    // Double SOF-marker, drop last one
-    if (input_queue.size() >= 2 && input_queue[1] == 0x7E) {
-        input_queue.pop();
+    if (echo != EchoCheck::NOT_ECHO) {
         return;
     }
 
-    input_queue.push(received_byte);
+    // A rejected frame is rescanned, which can complete several buffered frames at once
+    for (auto result = parser.push(received_byte); result != protocol::FrameParser::NEED_MORE &&
+                                                   result != protocol::FrameParser::DROPPED;
+         result = parser.poll()) {
+        switch (result) {
+            case protocol::FrameParser::FRAME:
+                bus_timing.on_frame(micros(), parser.frame().size, protocol::frame_channel(parser.frame()),
+                                    protocol::frame_type(parser.frame()), client_id);
+                last_received_time = millis();
+                if (resyncing) {
+                    last_resync_ms = last_received_time - resync_started;
+                    resyncing = false;
+                    ESP_LOGD(TAG, "Resynchronized after %u ms, %u bytes lost in total", (unsigned) last_resync_ms,
+                             (unsigned) parser.stats().bytes_lost);
+                }
+                handle_frame(parser.frame());
+                break;
+            case protocol::FrameParser::CRC_ERROR:
+            case protocol::FrameParser::LENGTH_ERROR:
+                ESP_LOGD(TAG, "%s, resynchronizing",
+                         result == protocol::FrameParser::CRC_ERROR ? "CRC mismatch" : "Frame length mismatch");
+                if (!resyncing) {
+                    resyncing = true;
+                    resync_started = millis();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
 
-    // Complete package
-    //if (received_byte == 0x7E && input_queue[0] == 0x7E && input_queue[1] != 0x7E) {
-    if (received_byte == 0x7E && input_queue.size() > 2 && input_queue.size() >= input_queue[1] + 2) {
+void BalboaSpa::handle_frame(protocol::ByteSpan frame) {
+    // Reject sizes the message type cannot have before anything is decoded from them
+    protocol::SizeCheck size_check = protocol::check_payload_size(frame);
+    if (size_check != protocol::SIZE_OK) {
+        if (size_check == protocol::SIZE_TOO_SHORT) {
+            frames_too_short++;
+        } else {
+            frames_too_long++;
+        }
+        ESP_LOGD(TAG, "Frame type 0x%02X with %u bytes is too %s, ignored", protocol::frame_type(frame),
+                 (unsigned) frame.size, size_check == protocol::SIZE_TOO_SHORT ? "short" : "long");
+        return;
+    }
 
-        if (input_queue.size() - 2 < input_queue[1]) {
-            ESP_LOGD(TAG, "packet_size: %d, recv_size: %d", input_queue[1], input_queue.size());
-            ESP_LOGD(TAG, "%s", "Packet incomplete!");
-            input_queue.clear();
-            return;
+    const uint8_t channel = protocol::frame_channel(frame);
+    const uint8_t type = protocol::frame_type(frame);
+    const bool changed = last_state_crc != protocol::frame_crc(frame);
+
+    // Unregistered or yet in progress
+    if (client_id == 0) {
+        ESP_LOGD(TAG, "Spa/node/id: %s", "Unregistered");
+        print_msg(frame);
+        // FE BF 02:got new client ID
+        if (channel == protocol::CHANNEL_NEW_CLIENT && type == protocol::MSG_CHANNEL_ASSIGNMENT) {
+            client_id = frame[protocol::OFFSET_PAYLOAD];
+            if (client_id > protocol::CHANNEL_MAX_CLIENT) client_id = protocol::CHANNEL_MAX_CLIENT;
+            ESP_LOGD(TAG, "Spa/node/id: Got ID: %d, acknowledging", client_id);
+            ID_ack();
+            ESP_LOGD(TAG, "Spa/node/id: %d", client_id);
+            warm_start_identity_dirty = true;
+            discovery.restart();
         }
 
-        auto calculated_crc = this->crc8(input_queue, true);
-        auto packet_crc = input_queue[input_queue[1]];
-        if (calculated_crc != packet_crc) {
-            ESP_LOGD(TAG, "CRC %d != Packet crc %d end=0x%X", calculated_crc, packet_crc, input_queue[input_queue[1] + 1]);
-            input_queue.clear();
+        // FE BF 00:Any new clients?
+        if (channel == protocol::CHANNEL_NEW_CLIENT && type == protocol::MSG_NEW_CLIENT_CLEAR_TO_SEND) {
+            ESP_LOGD(TAG, "Spa/node/id: %s", "Requesting ID");
+            ID_request();
+        }
+    } else if (channel == client_id && type == protocol::MSG_CLEAR_TO_SEND) { // we have an ID, do clever stuff
+        // client_id BF 06:Ready to Send
+        if (client_id_restored) {
+            ESP_LOGI(TAG, "Restored client ID %d confirmed", client_id);
+            client_id_restored = false;
+        }
+        if (echo_check.retransmit_due() && protocol::frame_channel(echo_check.retransmit_frame()) == client_id) {
+            protocol::ByteSpan collided = echo_check.retransmit_frame();
+            transmit(collided.data, collided.size);
+            echo_check.resent(millis());
             return;
         }
-
-        // Unregistered or yet in progress
-        if (client_id == 0) {
-            ESP_LOGD(TAG, "Spa/node/id: %s", "Unregistered");
-            //if (input_queue[2] == 0xFE) print_msg(input_queue);
-            print_msg(input_queue);
-            // FE BF 02:got new client ID
-            if (input_queue[2] == 0xFE && input_queue[4] == 0x02) {
-                client_id = input_queue[5];
-                if (client_id > 0x2F) client_id = 0x2F;
-                ESP_LOGD(TAG, "Spa/node/id: Got ID: %d, acknowledging", client_id);
-                ID_ack();
-                ESP_LOGD(TAG, "Spa/node/id: %d", client_id);
-            }
-
-            // FE BF 00:Any new clients?
-            if (input_queue[2] == 0xFE && input_queue[4] == 0x00) {
-                ESP_LOGD(TAG, "Spa/node/id: %s", "Requesting ID");
-                ID_request();
-            }
-        } else if (input_queue[2] == client_id && input_queue[4] == 0x06) { // we have an ID, do clever stuff
-            // client_id BF 06:Ready to Send
-            if (send_command == 0x21) {
-                output_queue.push(client_id);
-                output_queue.push(0xBF);
-                output_queue.push(0x21);
-                output_queue.push(target_hour);
-                output_queue.push(target_minute);
-            } else if (send_command == 0xff) {
-                // 0xff marks dirty temperature for now
-                output_queue.push(client_id);
-                output_queue.push(0xBF);
-                output_queue.push(0x20);
-                output_queue.push(target_temperature);
-            } else if (send_command == 0x00) {
-                if (config_request_status == 0) { // Get configuration of the hot tub
-                    output_queue.push(client_id);
-                    output_queue.push(0xBF);
-                    output_queue.push(0x22);
-                    output_queue.push(0x00);
-                    output_queue.push(0x00);
-                    output_queue.push(0x01);
-                    ESP_LOGD(TAG, "Spa/config/status: %s", "Getting config");
-                    config_request_status = 1;
-                } else if (faultlog_request_status == 0) { // Get the fault log
-                    output_queue.push(client_id);
-                    output_queue.push(0xBF);
-                    output_queue.push(0x22);
-                    output_queue.push(0x20);
-                    output_queue.push(0xFF);
-                    output_queue.push(0x00);
-                    faultlog_request_status = 1;
-                    ESP_LOGD(TAG, "Spa/debug/faultlog_request_status: %s", "requesting fault log, #1");
-                } else if ((filtersettings_request_status == 0) && (faultlog_request_status == 2)) { // Get the filter cycles log once we have the faultlog
-                    output_queue.push(client_id);
-                    output_queue.push(0xBF);
-                    output_queue.push(0x22);
-                    output_queue.push(0x01);
-                    output_queue.push(0x00);
-                    output_queue.push(0x00);
-                    ESP_LOGD(TAG, "Spa/debug/filtersettings_request_status: %s", "requesting filter settings, #1");
-                    filtersettings_request_status = 1;
-                } else {
-                    // A Nothing to Send message is sent by a client immediately after a Clear to Send message if the client has no messages to send.
-                    output_queue.push(client_id);
-                    output_queue.push(0xBF);
-                    output_queue.push(0x07);
-                }
+        // Toggles are worked out from the state, so wait until a live status replaced the restored one
+        if (send_command == 0x00 && !temperature_write.due() && !clock_write.due() && !filter_schedule_write_due &&
+            first_state_ms != 0) {
+            send_command = toggle_reconciler.next_toggle(spaState, millis());
+        }
+        if (temperature_write.due()) {
+            output_queue.push(client_id);
+            output_queue.push(protocol::MAGIC_TO_SPA);
+            output_queue.push(protocol::MSG_SET_TEMPERATURE);
+            output_queue.push(temperature_write.value());
+            temperature_write.mark_sent();
+        } else if (clock_write.due()) {
+            output_queue.push(client_id);
+            output_queue.push(protocol::MAGIC_TO_SPA);
+            output_queue.push(protocol::MSG_SET_TIME);
+            output_queue.push(clock_write.value() / 60);
+            output_queue.push(clock_write.value() % 60);
+            clock_write.mark_sent();
+        } else if (filter_schedule_write_due) {
+            queue_filter_schedule();
+            filter_schedule_write_due = false;
+            // Read the schedule back so the filter entities show what the spa took
+            discovery.refresh(SpaDiscovery::FILTER_CYCLES);
+        } else if (send_command == 0x00) {
+            SpaDiscovery::Request request = discovery.next(millis());
+            if (request != SpaDiscovery::REQUEST_COUNT) {
+                send_discovery_request(request);
             } else {
+                // A Nothing to Send message is sent by a client immediately after a Clear to Send message if the client has no messages to send.
                 output_queue.push(client_id);
-                output_queue.push(0xBF);
-                output_queue.push(0x11);
-                output_queue.push(send_command);
-                output_queue.push(0x00);
-            }
-
-            rs485_send();
-            send_command = 0x00;
-        } else if (input_queue[2] == client_id && input_queue[4] == 0x2E) {
-            if (last_state_crc != input_queue[input_queue[1]]) {
-                decodeSettings();
-            }
-        } else if (input_queue[2] == client_id && input_queue[4] == 0x28) {
-            if (last_state_crc != input_queue[input_queue[1]]) {
-                decodeFault();
-            }
-        } else if (input_queue[2] == 0xFF && input_queue[4] == 0x13) { // FF AF 13:Status Update - Packet index offset 5
-            if (last_state_crc != input_queue[input_queue[1]]) {
-                decodeState();
-            }
-        } else if (input_queue[2] == client_id && input_queue[4] == 0x23) { // FF AF 23:Filter Cycle Message - Packet index offset 5
-            if (last_state_crc != input_queue[input_queue[1]]) {
-                ESP_LOGD(TAG, "Spa/debug/faultlog_request_status: %s", "decoding filter settings");
-                decodeFilterSettings();
+                output_queue.push(protocol::MAGIC_TO_SPA);
+                output_queue.push(protocol::MSG_NOTHING_TO_SEND);
             }
         } else {
-            // DEBUG for finding meaning
-            //if (input_queue[2] & 0xFE || input_queue[2] == id)
-            //print_msg(input_queue);
+            output_queue.push(client_id);
+            output_queue.push(protocol::MAGIC_TO_SPA);
+            output_queue.push(protocol::MSG_TOGGLE_ITEM);
+            output_queue.push(send_command);
+            output_queue.push(0x00);
+            send_command = 0x00;
         }
 
-        // Clean up queue
-        input_queue.clear();
-    }
-    last_received_time = millis();
-}
-
-uint8_t BalboaSpa::crc8(CircularBuffer<uint8_t, 100> &data, bool ignore_delimiter) {
-    unsigned long crc_value;
-    int bit_index;
-    uint8_t data_length = ignore_delimiter ? data.size() - 2 : data.size();
-
-    crc_value = 0x02;
-    for (size_t byte_index = ignore_delimiter; byte_index < data_length; byte_index++) {
-        crc_value ^= data[byte_index];
-        for (bit_index = 0; bit_index < 8; bit_index++) {
-            if ((crc_value & 0x80) != 0) {
-                crc_value <<= 1;
-                crc_value ^= 0x7;
-            } else {
-                crc_value <<= 1;
-            }
+        rs485_send();
+    } else if (channel == client_id && type == protocol::MSG_CONFIGURATION) {
+        protocol::ConfigMessage config;
+        if (protocol::decode_config(frame, config)) {
+            if (changed) decodeSettings(config);
+            on_discovery_response(SpaDiscovery::CONFIGURATION);
+        }
+    } else if (channel == client_id && type == protocol::MSG_FAULT_LOG) {
+        protocol::FaultLogMessage fault;
+        if (protocol::decode_fault_log(frame, fault)) {
+            if (changed) decodeFault(fault);
+            on_discovery_response(SpaDiscovery::FAULT_LOG);
+        }
+    } else if (channel == client_id && type == protocol::MSG_INFORMATION) {
+        protocol::InformationMessage info;
+        if (protocol::decode_information(frame, info)) {
+            decodeInformation(info);
+            on_discovery_response(SpaDiscovery::INFORMATION);
+        }
+    } else if (channel == client_id && type == protocol::MSG_PREFERENCES) {
+        protocol::PreferencesMessage prefs;
+        if (protocol::decode_preferences(frame, prefs)) {
+            decodePreferences(prefs);
+            on_discovery_response(SpaDiscovery::PREFERENCES);
+        }
+    } else if (channel == protocol::CHANNEL_BROADCAST && type == protocol::MSG_STATUS) { // FF AF 13:Status Update - Packet index offset 5
+        protocol::StatusMessage status;
+        if (!protocol::decode_status(frame, status)) {
+            return;
+        }
+        if (changed) {
+            decodeState(frame, status);
+        }
+        if (first_state_ms == 0) {
+            first_state_ms = millis();
+            ESP_LOGI(TAG, "First status %u ms after boot", (unsigned) first_state_ms);
+            check_populated();
+        }
+        toggle_reconciler.on_status(spaState, millis());
+        confirm_writes(status);
+    } else if (channel == client_id && type == protocol::MSG_FILTER_CYCLES) { // FF AF 23:Filter Cycle Message - Packet index offset 5
+        protocol::FilterCyclesMessage filters;
+        if (protocol::decode_filter_cycles(frame, filters)) {
+            if (changed) decodeFilterSettings(filters);
+            on_discovery_response(SpaDiscovery::FILTER_CYCLES);
         }
     }
-    return crc_value ^ 0x02;
 }
 
 void BalboaSpa::ID_request() {
-    output_queue.push(0xFE);
-    output_queue.push(0xBF);
-    output_queue.push(0x01);
+    output_queue.push(protocol::CHANNEL_NEW_CLIENT);
+    output_queue.push(protocol::MAGIC_TO_SPA);
+    output_queue.push(protocol::MSG_CHANNEL_ASSIGNMENT_REQUEST);
     output_queue.push(0x02);
     output_queue.push(0xF1);
     output_queue.push(0x73);
@@ -336,39 +649,92 @@ void BalboaSpa::ID_request() {
 
 void BalboaSpa::ID_ack() {
     output_queue.push(client_id);
-    output_queue.push(0xBF);
-    output_queue.push(0x03);
+    output_queue.push(protocol::MAGIC_TO_SPA);
+    output_queue.push(protocol::MSG_CHANNEL_ASSIGNMENT_ACK);
 
     rs485_send();
 }
 
 void BalboaSpa::rs485_send() {
-    // Add telegram length
-    output_queue.unshift(output_queue.size() + 2);
-
-    // Add CRC
-    output_queue.push(crc8(output_queue, false));
+    // Adds length, CRC and the SOF/EOF delimiters
+    uint8_t frame[protocol::MAX_FRAME_SIZE];
+    size_t message_size = output_queue.size();
+    size_t frame_size = protocol::encode_queued_frame(output_queue, frame, sizeof(frame));
+    output_queue.clear();
+    if (frame_size == 0) {
+        ESP_LOGW(TAG, "Message of %u bytes does not fit a frame", (unsigned) message_size);
+        return;
+    }
 
-    // Wrap telegram in SOF/EOF
-    output_queue.unshift(0x7E);
-    output_queue.push(0x7E);
+    transmit(frame, frame_size);
+    // Frames on our own channel can be resent at our next clear-to-send if they collide. Toggles are
+    // not: the spa may have taken one whose echo was garbled, and the reconciler retries from the status.
+    bool retransmittable = client_id != 0 && frame[protocol::OFFSET_CHANNEL] == client_id &&
+                           frame[protocol::OFFSET_TYPE] != protocol::MSG_TOGGLE_ITEM;
+    echo_check.sent(frame, frame_size, retransmittable, millis());
+}
 
-    for (loop_index = 0; loop_index < output_queue.size(); loop_index++) {
-        write(output_queue[loop_index]);
+void BalboaSpa::transmit(const uint8_t *frame, size_t frame_size) {
+    bus_timing.on_transmit(micros());
+    if (flow_control_pin == nullptr) {
+        write_array(frame, frame_size);
+        flush();
+        return;
     }
 
-    //print_msg(output_queue);
-
+    uint32_t enabled_at = micros();
+    flow_control_pin->digital_write(true);
+    write_array(frame, frame_size);
+    // flush() returns once the UART has shifted out the last stop bit, so the bus is released right after
     flush();
+    flow_control_pin->digital_write(false);
+    uint32_t held_us = micros() - enabled_at;
+
+    // Whatever the driver was held beyond the frame's time on the wire delays the mainboard's next frame
+    uint32_t bits_per_byte = 1 + parent_->get_data_bits() + parent_->get_stop_bits();
+    uint32_t airtime_us = (uint64_t) frame_size * bits_per_byte * 1000000 / parent_->get_baud_rate();
+    float excess_us = held_us > airtime_us ? held_us - airtime_us : 0;
+    if (turnaround_samples++ == 0) {
+        turnaround_us = excess_us;
+    } else {
+        turnaround_us += (excess_us - turnaround_us) * TURNAROUND_SMOOTHING;
+    }
+}
 
-    // DEBUG: print_msg(output_queue);
-    output_queue.clear();
+void BalboaSpa::log_bus_timing() {
+    const GapHistogram &gaps = bus_timing.gaps();
+    const GapHistogram &replies = bus_timing.reply_latency();
+    if (gaps.total() == 0) {
+        return;
+    }
+    ESP_LOGD(TAG, "Bus timing: status every %.0f ms, CTS every %.0f ms, reply after %.0f us",
+             bus_timing.status_period_ms(), bus_timing.cts_period_ms(), bus_timing.reply_latency_us());
+    std::stringstream buckets;
+    for (uint8_t i = 0; i < GapHistogram::BUCKET_COUNT; i++) {
+        if (i < GapHistogram::BUCKET_COUNT - 1) {
+            buckets << " <" << GapHistogram::UPPER_BOUNDS_US[i] << ":";
+        } else {
+            buckets << " more:";
+        }
+        buckets << gaps.counts[i] << "/" << replies.counts[i];
+    }
+    ESP_LOGD(TAG, "Bus timing: gap/reply histogram (us)%s", buckets.str().c_str());
 }
 
-void BalboaSpa::print_msg(CircularBuffer<uint8_t, 100> &data) {
+void BalboaSpa::check_echo_timeout() {
+    if (!echo_check.expired(millis())) {
+        return;
+    }
+    ESP_LOGD(TAG, "Collision: no complete echo of the sent frame");
+    if (echo_check.silent_sends() == ECHO_SILENT_SENDS_WARNING) {
+        ESP_LOGW(TAG, "No echo for the last %u frames; disable echo_check if the transceiver does not echo",
+                 ECHO_SILENT_SENDS_WARNING);
+    }
+}
+
+void BalboaSpa::print_msg(protocol::ByteSpan data) {
     std::stringstream debug_stream;
-    //for (loop_index = 0; loop_index < (input_queue[1] + 2); loop_index++) {
-    for (loop_index = 0; loop_index < data.size(); loop_index++) {
+    for (loop_index = 0; loop_index < data.size; loop_index++) {
         received_byte = data[loop_index];
         if (received_byte < 0x0A) debug_stream << "0";
         debug_stream << std::hex << received_byte;
@@ -377,22 +743,22 @@ void BalboaSpa::print_msg(CircularBuffer<uint8_t, 100> &data) {
     yield();
 }
 
-void BalboaSpa::decodeSettings() {
+void BalboaSpa::decodeSettings(const protocol::ConfigMessage &config) {
     ESP_LOGD(TAG, "Spa/config/status: Got config");
-    spaConfig.pump1 = input_queue[5] & 0x03;
-    spaConfig.pump2 = (input_queue[5] & 0x0C) >> 2;
-    spaConfig.pump3 = (input_queue[5] & 0x30) >> 4;
-    spaConfig.pump4 = (input_queue[5] & 0xC0) >> 6;
-    spaConfig.pump5 = (input_queue[6] & 0x03);
-    spaConfig.pump6 = (input_queue[6] & 0xC0) >> 6;
-    spaConfig.light1 = (input_queue[7] & 0x03);
-    spaConfig.light2 = (input_queue[7] >> 2) & 0x03;
-    spaConfig.circ = ((input_queue[8] & 0x80) != 0);
-    spaConfig.blower = ((input_queue[8] & 0x03) != 0);
-    spaConfig.mister = ((input_queue[9] & 0x30) != 0);
-    spaConfig.aux1 = ((input_queue[9] & 0x01) != 0);
-    spaConfig.aux2 = ((input_queue[9] & 0x02) != 0);
-    spaConfig.temperature_scale = input_queue[3] & 0x01; //Read temperature scale - 0 -> Farenheit, 1-> Celcius
+    spaConfig.pump1 = config.pumps[0];
+    spaConfig.pump2 = config.pumps[1];
+    spaConfig.pump3 = config.pumps[2];
+    spaConfig.pump4 = config.pumps[3];
+    spaConfig.pump5 = config.pumps[4];
+    spaConfig.pump6 = config.pumps[5];
+    spaConfig.light1 = config.light1;
+    spaConfig.light2 = config.light2;
+    spaConfig.circ = config.circulation;
+    spaConfig.blower = config.blower;
+    spaConfig.mister = config.mister;
+    spaConfig.aux1 = config.aux1;
+    spaConfig.aux2 = config.aux2;
+    spaConfig.temperature_scale = config.temperature_scale; //Read temperature scale - 0 -> Farenheit, 1-> Celcius
     ESP_LOGD(TAG, "Spa/config/pumps1: %d", spaConfig.pump1);
     ESP_LOGD(TAG, "Spa/config/pumps2: %d", spaConfig.pump2);
     ESP_LOGD(TAG, "Spa/config/pumps3: %d", spaConfig.pump3);
@@ -407,30 +773,60 @@ void BalboaSpa::decodeSettings() {
     ESP_LOGD(TAG, "Spa/config/aux1: %d", spaConfig.aux1);
     ESP_LOGD(TAG, "Spa/config/aux2: %d", spaConfig.aux2);
     ESP_LOGD(TAG, "Spa/config/temperature_scale: %d", spaConfig.temperature_scale);
-    config_request_status = 2;
+    warm_start_identity_dirty = true;
+    apply_config();
+}
+
+void BalboaSpa::apply_config() {
+    uint16_t equipment = EQUIPMENT_NONE;
+    const uint8_t pumps[] = {spaConfig.pump1, spaConfig.pump2, spaConfig.pump3, spaConfig.pump4, spaConfig.pump5, spaConfig.pump6};
+    for (uint8_t i = 0; i < 6; i++) {
+        if (pumps[i] != 0) {
+            equipment |= EQUIPMENT_PUMP1 << i;
+        }
+    }
+    if (spaConfig.light1) equipment |= EQUIPMENT_LIGHT1;
+    if (spaConfig.light2) equipment |= EQUIPMENT_LIGHT2;
+    if (spaConfig.circ) equipment |= EQUIPMENT_CIRCULATION;
+    if (spaConfig.blower) equipment |= EQUIPMENT_BLOWER;
+    if (spaConfig.mister) equipment |= EQUIPMENT_MISTER;
+    if (spaConfig.aux1) equipment |= EQUIPMENT_AUX1;
+    if (spaConfig.aux2) equipment |= EQUIPMENT_AUX2;
+    if (equipment != equipment_present) {
+        ESP_LOGI(TAG, "Spa/config/equipment: 0x%04X", equipment);
+        equipment_present = equipment;
+
+        uint8_t absent = 0;
+        for (const auto &listener : listeners_) {
+            absent += !has_equipment(listener.equipment);
+        }
+        if (absent > 0) {
+            ESP_LOGW(TAG, "%d entities are for equipment this spa does not have and will not be updated", absent);
+        }
+    }
 
     if (spa_temp_scale == TEMP_SCALE::UNDEFINED) {
         spa_temp_scale = static_cast<TEMP_SCALE>(spaConfig.temperature_scale);
     }
 }
 
-void BalboaSpa::decodeState() {
+void BalboaSpa::decodeState(protocol::ByteSpan frame, const protocol::StatusMessage &status) {
 
     // Debug temperature parsing
     ESP_LOGD(TAG, "Temperature parsing - spa_temp_scale: %d, esphome_temp_scale: %d", spa_temp_scale, esphome_temp_scale);
-    ESP_LOGD(TAG, "Raw temperature bytes - target: 0x%02X, current: 0x%02X", input_queue[25], input_queue[7]);
+    ESP_LOGD(TAG, "Raw temperature bytes - target: 0x%02X, current: 0x%02X", status.target_temp, status.current_temp);
     
     // 25:Flag Byte 20 - Set Temperature (Target)
-    if (input_queue[25] != 0xFF) {  // Check for valid temperature value
+    if (status.target_temp != 0xFF) {  // Check for valid temperature value
         double temp_read = 0.0;
 
         if (spa_temp_scale == TEMP_SCALE::C) {
-            temp_read = input_queue[25] / 2.0;
+            temp_read = status.target_temp / 2.0;
         } else if (spa_temp_scale == TEMP_SCALE::F) {
-            temp_read = convert_f_to_c(input_queue[25]);
+            temp_read = convert_f_to_c(status.target_temp);
         } else {
             ESP_LOGW(TAG, "Unknown spa temperature scale: %d", spa_temp_scale);
-            temp_read = input_queue[25] / 2.0; // Default to Celsius
+            temp_read = status.target_temp / 2.0; // Default to Celsius
         }
         
         // Validate temperature range
@@ -443,23 +839,23 @@ void BalboaSpa::decodeState() {
                 ESP_LOGD(TAG, "Spa/temperature/target: %.2f F", spaState.target_temp);
             }
         } else {
-            ESP_LOGW(TAG, "Target temperature out of range: %.2f (raw: 0x%02X)", temp_read, input_queue[25]);
+            ESP_LOGW(TAG, "Target temperature out of range: %.2f (raw: 0x%02X)", temp_read, status.target_temp);
         }
     } else {
         ESP_LOGD(TAG, "Target temperature byte is 0xFF (no valid value)");
     }
 
     // 7:Flag Byte 2 - Actual temperature (Current)
-    if (input_queue[7] != 0xFF) {  // Check for valid temperature value
+    if (status.current_temp != 0xFF) {  // Check for valid temperature value
         double temp_read = 0.0;
 
         if (spa_temp_scale == TEMP_SCALE::C) {
-            temp_read = input_queue[7] / 2.0;
+            temp_read = status.current_temp / 2.0;
         } else if (spa_temp_scale == TEMP_SCALE::F) {
-            temp_read = convert_f_to_c(input_queue[7]);
+            temp_read = convert_f_to_c(status.current_temp);
         } else {
             ESP_LOGW(TAG, "Unknown spa temperature scale: %d", spa_temp_scale);
-            temp_read = input_queue[7] / 2.0; // Default to Celsius
+            temp_read = status.current_temp / 2.0; // Default to Celsius
         }
         
         // Validate temperature range
@@ -472,7 +868,7 @@ void BalboaSpa::decodeState() {
                 ESP_LOGD(TAG, "Spa/temperature/current: %.2f F", spaState.current_temp);
             }
         } else {
-            ESP_LOGW(TAG, "Current temperature out of range: %.2f (raw: 0x%02X)", temp_read, input_queue[7]);
+            ESP_LOGW(TAG, "Current temperature out of range: %.2f (raw: 0x%02X)", temp_read, status.current_temp);
         }
     } else {
         ESP_LOGD(TAG, "Current temperature byte is 0xFF (no valid value)");
@@ -480,121 +876,85 @@ void BalboaSpa::decodeState() {
 
     // 8:Flag Byte 3 Hour & 9:Flag Byte 4 Minute => Time
 
-    target_hour = input_queue[8];
-    target_minute = input_queue[9];
+    uint8_t spa_hour = status.hour;
+    uint8_t spa_minute = status.minute;
 
-    if (target_hour != spaState.hour || target_minute != spaState.minutes) {
+    if (spa_hour != spaState.hour || spa_minute != spaState.minutes) {
         // Do not trigger a new state for clock
         // newState = true;
         // ESP_LOGD(TAG, "Spa/time/state %s", s.c_str());
-        spaState.hour = target_hour;
-        spaState.minutes = target_minute;
-    }
-
-    spaState.rest_mode = input_queue[10];
-
-    // 15:Flags Byte 10 / Heat status, Temp Range
-    spaState.heat_state = bitRead(input_queue[15], 4);
-
-    double spa_component_state = bitRead(input_queue[15], 2);
-    if (spa_component_state != spaState.highrange) {
-        ESP_LOGD(TAG, "Spa/highrange/state: %.0f", spa_component_state); //LOW
-        spaState.highrange = spa_component_state;
-    }
-
-    // 16:Flags Byte 11
-    spa_component_state = bitRead(input_queue[16], 1);
-    if (spa_component_state != spaState.jet1) {
-        ESP_LOGD(TAG, "Spa/jet_1/state: %.0f", spa_component_state);
-        spaState.jet1 = spa_component_state;
-    }
-
-    spa_component_state = bitRead(input_queue[16], 3);
-    if (spa_component_state != spaState.jet2) {
-        ESP_LOGD(TAG, "Spa/jet_2/state: %.0f", spa_component_state);
-        spaState.jet2 = spa_component_state;
-    }
-
-    spa_component_state = bitRead(input_queue[16], 5);
-    if (spa_component_state != spaState.jet3) {
-        ESP_LOGD(TAG, "Spa/jet_3/state: %.0f", spa_component_state);
-        spaState.jet3 = spa_component_state;
-    }
-
-    spa_component_state = bitRead(input_queue[16], 7);
-    if (spa_component_state != spaState.jet4)
-    {
-      ESP_LOGD(TAG, "Spa/jet_4/state: %.0f", spa_component_state);
-      spaState.jet4 = spa_component_state;
-    }
-
-    // 18:Flags Byte 13
-    spa_component_state = bitRead(input_queue[18], 1);
-    if (spa_component_state != spaState.circulation) {
-        ESP_LOGD(TAG, "Spa/circ/state: %.0f", spa_component_state);
-        spaState.circulation = spa_component_state;
-    }
-
-    spa_component_state = bitRead(input_queue[18], 2);
-    if (spa_component_state != spaState.blower) {
-        ESP_LOGD(TAG, "Spa/blower/state: %.0f", spa_component_state);
-        spaState.blower = spa_component_state;
+#ifdef USE_TIME
+        // A change we did not cause is the spa minute ticking over
+        if (spa_clock_known && !clock_write.pending()) {
+            observe_spa_clock_tick(spa_hour, spa_minute);
+        }
+#endif
+        spaState.hour = spa_hour;
+        spaState.minutes = spa_minute;
+        spa_clock_known = true;
     }
 
-    spa_component_state = input_queue[19] == 0x03;
-    // 19:Flags Byte 14
-    if (spa_component_state != spaState.light) {
-        ESP_LOGD(TAG, "Spa/light/state: %.0f", spa_component_state);
-        spaState.light = spa_component_state;
-    }
+    // Equipment states, skipping what the configuration did not report
+    apply_status(status, equipment_present, spaState);
 
     // Store the raw status bytes for debugging
-    last_status_byte_16 = input_queue[16];
-    last_status_byte_17 = input_queue[17];
-    last_status_byte_18 = input_queue[18];
-    last_status_byte_19 = input_queue[19];
+    last_status_byte_16 = frame[16];
+    last_status_byte_17 = frame[17];
+    last_status_byte_18 = frame[18];
+    last_status_byte_19 = frame[19];
     ESP_LOGD(TAG, "Spa/debug/status_bytes: 16=0x%02X 17=0x%02X 18=0x%02X 19=0x%02X", 
              last_status_byte_16, last_status_byte_17, last_status_byte_18, last_status_byte_19);
 
-    // Decode actual pump status from byte 16
-    // Pump 1: bits 0-1 (0x03) - 0=off, 1=low, 2=high
-    uint8_t pump1_status = input_queue[16] & 0x03;
-    if (pump1_status != spaState.pump1) {
-        ESP_LOGD(TAG, "Spa/pump1/actual_state: %d", pump1_status);
-        spaState.pump1 = pump1_status;
-    }
-    
-    // Pump 2: bits 3-4 (0x18) - 0=off, 8=on (bit 3 set)
-    uint8_t pump2_status = (input_queue[16] & 0x18) >> 3;
-    if (pump2_status != spaState.pump2) {
-        ESP_LOGD(TAG, "Spa/pump2/actual_state: %d", pump2_status);
-        spaState.pump2 = pump2_status;
-    }
-    
-    // Pump 3: not used in your spa
-    spaState.pump3 = 0;
+    heating_estimator.update(millis(), spaState.current_temp, spaState.heat_state == 1);
 
     // Filter status tracking
     update_filter_status();
 
     // TODO: callback on newState
 
-    last_state_crc = input_queue[input_queue[1]];
+    last_state_crc = protocol::frame_crc(frame);
 }
 
-void BalboaSpa::decodeFilterSettings() {
-    spaFilterSettings.filter1_hour = input_queue[5];
-    spaFilterSettings.filter1_minute = input_queue[6];
-    spaFilterSettings.filter1_duration_hour = input_queue[7];
-    spaFilterSettings.filter1_duration_minute = input_queue[8];
+static void log_write_outcome(const char *name, VerifiedWrite::Outcome outcome, const VerifiedWrite &write) {
+    if (outcome == VerifiedWrite::RETRY) {
+        ESP_LOGD(TAG, "%s write not confirmed, resending", name);
+    } else if (outcome == VerifiedWrite::ABANDONED) {
+        ESP_LOGW(TAG, "%s write of %d abandoned, the spa did not take it", name, write.value());
+    }
+}
+
+void BalboaSpa::confirm_writes(const protocol::StatusMessage &status) {
+    // Runs on every status frame, including unchanged ones that are not decoded into SpaState
+    auto outcome = temperature_write.on_status(status.target_temp == temperature_write.value());
+    log_write_outcome("Set temperature", outcome, temperature_write);
+
+    // A manual write may see the clock tick over before the status frame. A sync needs the exact
+    // minute: it is sent at second 0-2, and a spa clock less than two minutes off would already
+    // be within one minute of it.
+    uint16_t spa_minutes = status.hour * 60 + status.minute;
+    uint16_t minutes_ahead = (spa_minutes + MINUTES_PER_DAY - clock_write.value()) % MINUTES_PER_DAY;
+    outcome = clock_write.on_status(minutes_ahead <= (clock_write_exact ? 0 : 1));
+    log_write_outcome("Clock", outcome, clock_write);
+    // CONFIRMED only follows a write that went out, so the spa clock really was set
+    if (outcome == VerifiedWrite::CONFIRMED && clock_write.attempts() > 0) {
+        // Whatever set it, the old drift anchor no longer matches the spa clock
+        clock_sync.clock_set();
+    }
+}
+
+void BalboaSpa::decodeFilterSettings(const protocol::FilterCyclesMessage &filters) {
+    spaFilterSettings.filter1_hour = filters.filter1_hour;
+    spaFilterSettings.filter1_minute = filters.filter1_minute;
+    spaFilterSettings.filter1_duration_hour = filters.filter1_duration_hour;
+    spaFilterSettings.filter1_duration_minute = filters.filter1_duration_minute;
     
     // Always trust the spa response for filter2_enable state
-    spaFilterSettings.filter2_enable = bitRead(input_queue[9], 7);
+    spaFilterSettings.filter2_enable = filters.filter2_enable;
     
-    spaFilterSettings.filter2_hour = input_queue[9] & 0x1F; // Clear bit 7, keep bits 0-4 for hour
-    spaFilterSettings.filter2_minute = input_queue[10];
-    spaFilterSettings.filter2_duration_hour = input_queue[11];
-    spaFilterSettings.filter2_duration_minute = input_queue[12];
+    spaFilterSettings.filter2_hour = filters.filter2_hour;
+    spaFilterSettings.filter2_minute = filters.filter2_minute;
+    spaFilterSettings.filter2_duration_hour = filters.filter2_duration_hour;
+    spaFilterSettings.filter2_duration_minute = filters.filter2_duration_minute;
 
     //Filter 1 time conversion
     static PROGMEM const char *format_string = R"({"start":"%.2i:%.2i","duration":"%.2i:%.2i"} )";
@@ -610,78 +970,17 @@ void BalboaSpa::decodeFilterSettings() {
     std::snprintf(filter_payload, payload_length + 1, format_string, spaFilterSettings.filter2_hour, spaFilterSettings.filter2_minute, spaFilterSettings.filter2_duration_hour, spaFilterSettings.filter2_duration_minute);
     ESP_LOGD(TAG, "Spa/filter2/state: %s", filter_payload);
 
-    filtersettings_request_status = 2;
-}
-
-void BalboaSpa::decodeFault() {
-    spaFaultLog.total_entries = input_queue[5];
-    spaFaultLog.current_entry = input_queue[6];
-    spaFaultLog.fault_code = input_queue[7];
-    switch (spaFaultLog.fault_code) { // this is a inelegant way to do it, a lookup table would be better
-        case 15:
-            spaFaultLog.fault_message = "Sensors are out of sync";
-            break;
-        case 16:
-            spaFaultLog.fault_message = "The water flow is low";
-            break;
-        case 17:
-            spaFaultLog.fault_message = "The water flow has failed";
-            break;
-        case 18:
-            spaFaultLog.fault_message = "The settings have been reset";
-            break;
-        case 19:
-            spaFaultLog.fault_message = "Priming Mode";
-            break;
-        case 20:
-            spaFaultLog.fault_message = "The clock has failed";
-            break;
-        case 21:
-            spaFaultLog.fault_message = "The settings have been reset";
-            break;
-        case 22:
-            spaFaultLog.fault_message = "Program memory failure";
-            break;
-        case 26:
-            spaFaultLog.fault_message = "Sensors are out of sync -- Call for service";
-            break;
-        case 27:
-            spaFaultLog.fault_message = "The heater is dry";
-            break;
-        case 28:
-            spaFaultLog.fault_message = "The heater may be dry";
-            break;
-        case 29:
-            spaFaultLog.fault_message = "The water is too hot";
-            break;
-        case 30:
-            spaFaultLog.fault_message = "The heater is too hot";
-            break;
-        case 31:
-            spaFaultLog.fault_message = "Sensor A Fault";
-            break;
-        case 32:
-            spaFaultLog.fault_message = "Sensor B Fault";
-            break;
-        case 34:
-            spaFaultLog.fault_message = "A pump may be stuck on";
-            break;
-        case 35:
-            spaFaultLog.fault_message = "Hot fault";
-            break;
-        case 36:
-            spaFaultLog.fault_message = "The GFCI test failed";
-            break;
-        case 37:
-            spaFaultLog.fault_message = "Standby Mode (Hold Mode)";
-            break;
-        default:
-            spaFaultLog.fault_message = "Unknown error";
-            break;
-    }
-    spaFaultLog.days_ago = input_queue[8];
-    spaFaultLog.hour = input_queue[9];
-    spaFaultLog.minutes = input_queue[10];
+    warm_start_identity_dirty = true;
+}
+
+void BalboaSpa::decodeFault(const protocol::FaultLogMessage &fault) {
+    spaFaultLog.total_entries = fault.total_entries;
+    spaFaultLog.current_entry = fault.current_entry;
+    spaFaultLog.fault_code = fault.fault_code;
+    spaFaultLog.fault_message = protocol::fault_message(fault.fault_code);
+    spaFaultLog.days_ago = fault.days_ago;
+    spaFaultLog.hour = fault.hour;
+    spaFaultLog.minutes = fault.minute;
     ESP_LOGD(TAG, "Spa/fault/Entries: %d", spaFaultLog.total_entries);
     ESP_LOGD(TAG, "Spa/fault/Entry: %d", spaFaultLog.current_entry);
     ESP_LOGD(TAG, "Spa/fault/Code: %d", spaFaultLog.fault_code);
@@ -689,11 +988,20 @@ void BalboaSpa::decodeFault() {
     ESP_LOGD(TAG, "Spa/fault/DaysAgo: %d", spaFaultLog.days_ago);
     ESP_LOGD(TAG, "Spa/fault/Hours: %d", spaFaultLog.hour);
     ESP_LOGD(TAG, "Spa/fault/Minutes: %d", spaFaultLog.minutes);
-    faultlog_request_status = 2;
-    //ESP_LOGD(TAG, "Spa/debug/faultlog_request_status: have the faultlog, #2");
 }
 
-bool BalboaSpa::is_communicating() {
+void BalboaSpa::decodeInformation(const protocol::InformationMessage &info) {
+    ESP_LOGI(TAG, "Spa model %s, software M%u_%u V%u.%u, heater %s type %u, DIP switches 0x%04X", info.model,
+             info.software_id[0], info.software_id[1], info.software_id[2], info.software_id[3],
+             info.heater_voltage == 1 ? "240V" : "120V", info.heater_type, info.dip_switches);
+}
+
+void BalboaSpa::decodePreferences(const protocol::PreferencesMessage &prefs) {
+    ESP_LOGI(TAG, "Spa preferences: %s, %s clock, reminders %s, cleanup cycle %u min", prefs.temperature_scale ? "Celsius" : "Fahrenheit",
+             prefs.clock_24h ? "24h" : "12h", prefs.reminders ? "on" : "off", prefs.cleanup_cycle * 30);
+}
+
+bool BalboaSpa::is_communicating() const {
     return client_id != 0;
 }
 
@@ -733,23 +1041,9 @@ void BalboaSpa::set_filter1_schedule(uint8_t start_hour, uint8_t start_minute, u
     spaFilterSettings.filter1_duration_hour = duration_hour;
     spaFilterSettings.filter1_duration_minute = duration_minute;
     
-    // Send filter settings update command
-    if (client_id != 0) {
-        output_queue.push(client_id);
-        output_queue.push(0xBF);
-        output_queue.push(0x22);
-        output_queue.push(0x01);
-        output_queue.push(start_hour);
-        output_queue.push(start_minute);
-        output_queue.push(duration_hour);
-        output_queue.push(duration_minute);
-        output_queue.push(spaFilterSettings.filter2_hour | (spaFilterSettings.filter2_enable << 7));
-        output_queue.push(spaFilterSettings.filter2_minute);
-        output_queue.push(spaFilterSettings.filter2_duration_hour);
-        output_queue.push(spaFilterSettings.filter2_duration_minute);
-        ESP_LOGD(TAG, "Updating filter 1 schedule: %02d:%02d for %02d:%02d", start_hour, start_minute, duration_hour, duration_minute);
-        rs485_send();
-    }
+    // Sent at the next clear-to-send, then read back
+    filter_schedule_write_due = true;
+    ESP_LOGD(TAG, "Updating filter 1 schedule: %02d:%02d for %02d:%02d", start_hour, start_minute, duration_hour, duration_minute);
 }
 
 void BalboaSpa::set_filter2_schedule(uint8_t start_hour, uint8_t start_minute, uint8_t duration_hour, uint8_t duration_minute) {
@@ -769,51 +1063,47 @@ void BalboaSpa::set_filter2_schedule(uint8_t start_hour, uint8_t start_minute, u
     spaFilterSettings.filter2_duration_hour = duration_hour;
     spaFilterSettings.filter2_duration_minute = duration_minute;
     
-    // Send filter settings update command
-    if (client_id != 0) {
-        output_queue.push(client_id);
-        output_queue.push(0xBF);
-        output_queue.push(0x22);
-        output_queue.push(0x01);
-        output_queue.push(spaFilterSettings.filter1_hour);
-        output_queue.push(spaFilterSettings.filter1_minute);
-        output_queue.push(spaFilterSettings.filter1_duration_hour);
-        output_queue.push(spaFilterSettings.filter1_duration_minute);
-        output_queue.push(start_hour | (spaFilterSettings.filter2_enable << 7));
-        output_queue.push(start_minute);
-        output_queue.push(duration_hour);
-        output_queue.push(duration_minute);
-        ESP_LOGD(TAG, "Updating filter 2 schedule: %02d:%02d for %02d:%02d", start_hour, start_minute, duration_hour, duration_minute);
-        rs485_send();
-    }
+    // Sent at the next clear-to-send, then read back
+    filter_schedule_write_due = true;
+    ESP_LOGD(TAG, "Updating filter 2 schedule: %02d:%02d for %02d:%02d", start_hour, start_minute, duration_hour, duration_minute);
 }
 
 
 
+void BalboaSpa::queue_filter_schedule() {
+    output_queue.push(client_id);
+    output_queue.push(protocol::MAGIC_TO_SPA);
+    output_queue.push(protocol::MSG_SETTINGS_REQUEST);
+    output_queue.push(0x01);
+    output_queue.push(spaFilterSettings.filter1_hour);
+    output_queue.push(spaFilterSettings.filter1_minute);
+    output_queue.push(spaFilterSettings.filter1_duration_hour);
+    output_queue.push(spaFilterSettings.filter1_duration_minute);
+    output_queue.push(spaFilterSettings.filter2_hour | (spaFilterSettings.filter2_enable << 7));
+    output_queue.push(spaFilterSettings.filter2_minute);
+    output_queue.push(spaFilterSettings.filter2_duration_hour);
+    output_queue.push(spaFilterSettings.filter2_duration_minute);
+}
+
 void BalboaSpa::request_filter_settings() {
-    // Send filter configuration request according to protocol
-    if (client_id != 0) {
-        output_queue.push(client_id);
-        output_queue.push(0xBF);
-        output_queue.push(0x22);
-        output_queue.push(0x01);
-        output_queue.push(0x00);
-        output_queue.push(0x00);
-        ESP_LOGD(TAG, "Requesting filter settings from spa");
-        rs485_send();
-    }
+    // Goes out at the next clear-to-send, with a timeout and retries like the other settings requests
+    discovery.refresh(SpaDiscovery::FILTER_CYCLES);
+    ESP_LOGD(TAG, "Requesting filter settings from spa");
 }
 
 void BalboaSpa::reset_filter_runtime(uint8_t filter_number) {
     if (filter_number == 1) {
-        spaState.filter1_runtime_hours = 0;
+        spaState.filter1_runtime_seconds = 0;
         ESP_LOGD(TAG, "Reset filter 1 runtime hours");
     } else if (filter_number == 2) {
-        spaState.filter2_runtime_hours = 0;
+        spaState.filter2_runtime_seconds = 0;
         ESP_LOGD(TAG, "Reset filter 2 runtime hours");
     } else {
         ESP_LOGW(TAG, "Invalid filter number for runtime reset: %d", filter_number);
+        return;
     }
+    filter_counters_dirty = true;
+    save_filter_counters(true);
 }
 
 void BalboaSpa::reset_filter_cycles(uint8_t filter_number) {
@@ -825,7 +1115,183 @@ void BalboaSpa::reset_filter_cycles(uint8_t filter_number) {
         ESP_LOGD(TAG, "Reset filter 2 cycles completed");
     } else {
         ESP_LOGW(TAG, "Invalid filter number for cycles reset: %d", filter_number);
+        return;
     }
+    filter_counters_dirty = true;
+    save_filter_counters(true);
+}
+
+void BalboaSpa::restore_filter_counters() {
+    // in_flash=true so ESP8266 keeps the counters across power loss, not just in RTC memory
+    filter_counters_pref = global_preferences->make_preference<SpaFilterCounters>(
+        fnv1_hash("balboa_spa_filter_counters") + FILTER_COUNTERS_PREF_VERSION, true);
+
+    SpaFilterCounters counters{};
+    if (!filter_counters_pref.load(&counters)) {
+        ESP_LOGD(TAG, "No stored filter counters, starting from zero");
+        return;
+    }
+    spaState.filter1_runtime_seconds = counters.filter1_runtime_seconds;
+    spaState.filter2_runtime_seconds = counters.filter2_runtime_seconds;
+    spaState.filter1_cycles_completed = counters.filter1_cycles_completed;
+    spaState.filter2_cycles_completed = counters.filter2_cycles_completed;
+    ESP_LOGD(TAG, "Restored filter counters: F1 %.2f h / %d cycles, F2 %.2f h / %d cycles",
+             get_filter1_runtime_hours(), counters.filter1_cycles_completed,
+             get_filter2_runtime_hours(), counters.filter2_cycles_completed);
+}
+
+void BalboaSpa::save_filter_counters(bool force) {
+    if (!filter_counters_dirty) {
+        return;
+    }
+    uint32_t now = millis();
+    // Unless forced, coalesce changes so there is at most one write per persist interval
+    if (!force && last_filter_counters_save != 0 && now - last_filter_counters_save < filter_persist_interval) {
+        return;
+    }
+
+    SpaFilterCounters counters{};
+    counters.filter1_runtime_seconds = spaState.filter1_runtime_seconds;
+    counters.filter2_runtime_seconds = spaState.filter2_runtime_seconds;
+    counters.filter1_cycles_completed = spaState.filter1_cycles_completed;
+    counters.filter2_cycles_completed = spaState.filter2_cycles_completed;
+    if (!filter_counters_pref.save(&counters)) {
+        ESP_LOGW(TAG, "Failed to store filter counters");
+        return;
+    }
+    filter_counters_dirty = false;
+    last_filter_counters_save = now;
+
+    if (now - filter_counter_writes_day_start >= MS_PER_DAY) {
+        filter_counter_writes_day_start = now;
+        filter_counter_writes_today = 0;
+    }
+    filter_counter_writes_today++;
+    ESP_LOGD(TAG, "Stored filter counters (%d writes in the last day)", filter_counter_writes_today);
+}
+
+void BalboaSpa::restore_warm_start() {
+    if (!warm_start) {
+        return;
+    }
+    warm_start_pref = global_preferences->make_preference<SpaWarmStart>(
+        fnv1_hash("balboa_spa_warm_start") + WARM_START_PREF_VERSION, true);
+    SpaWarmStart stored{};
+    if (!warm_start_pref.load(&stored)) {
+        ESP_LOGD(TAG, "No stored warm start state, starting cold");
+        return;
+    }
+    warm_start_saved = stored;
+    last_warm_start_save = millis();  // the restored status is recent enough, no write on every boot
+
+    // Configuration first, it decides the temperature scale and which equipment is decoded
+    if (stored.has_config) {
+        spaConfig = stored.config;
+        config_restored = true;
+        apply_config();
+    }
+    if (stored.has_filter_settings) {
+        spaFilterSettings = stored.filter_settings;
+        filter_settings_restored = true;
+    }
+    if (stored.has_state) {
+        stored.apply_state(spaState);
+    }
+    if (stored.client_id != 0 && stored.client_id <= protocol::CHANNEL_MAX_CLIENT) {
+        // Entities publish the restored values as soon as there is a client ID
+        client_id = stored.client_id;
+        client_id_restored = true;
+    }
+    ESP_LOGI(TAG, "Warm start: client ID %d, config %s, filter settings %s, state %s", stored.client_id,
+             stored.has_config ? "YES" : "NO", stored.has_filter_settings ? "YES" : "NO",
+             stored.has_state ? "YES" : "NO");
+}
+
+void BalboaSpa::save_warm_start(uint32_t now, bool force) {
+    // Only values the bus has confirmed since boot are worth keeping
+    if (!is_communicating() || client_id_restored || first_state_ms == 0) {
+        return;
+    }
+
+    SpaWarmStart snapshot;
+    std::memset(&snapshot, 0, sizeof(snapshot));  // padding too, so unchanged snapshots compare equal
+    snapshot.client_id = client_id;
+    snapshot.has_config = discovery.received(SpaDiscovery::CONFIGURATION) || config_restored;
+    snapshot.config = spaConfig;
+    snapshot.has_filter_settings = discovery.received(SpaDiscovery::FILTER_CYCLES) || filter_settings_restored;
+    snapshot.filter_settings = spaFilterSettings;
+    snapshot.capture_state(spaState);
+    warm_start_identity_dirty = false;
+
+    // Identity changes are written straight away, the status is coalesced like the filter counters
+    bool identity_changed = !snapshot.same_identity(warm_start_saved);
+    if (!identity_changed && !force && last_warm_start_save != 0 &&
+        now - last_warm_start_save < warm_start_persist_interval) {
+        return;
+    }
+    if (std::memcmp(&snapshot, &warm_start_saved, sizeof(snapshot)) == 0) {
+        last_warm_start_save = now;
+        return;
+    }
+    if (!warm_start_pref.save(&snapshot)) {
+        ESP_LOGW(TAG, "Failed to store warm start state");
+        return;
+    }
+    warm_start_saved = snapshot;
+    last_warm_start_save = now;
+    ESP_LOGD(TAG, "Stored warm start state%s", identity_changed ? " (client ID, config or filter settings changed)" : "");
+}
+
+void BalboaSpa::check_populated() {
+    if (populated_ms != 0 || first_state_ms == 0 || !discovery.received(SpaDiscovery::CONFIGURATION) ||
+        !discovery.received(SpaDiscovery::FILTER_CYCLES)) {
+        return;
+    }
+    populated_ms = millis();
+    ESP_LOGI(TAG, "State, configuration and filter settings live %u ms after boot", (unsigned) populated_ms);
+}
+
+void BalboaSpa::send_discovery_request(SpaDiscovery::Request request) {
+    const uint8_t *payload = SpaDiscovery::payload(request);
+    output_queue.push(client_id);
+    output_queue.push(protocol::MAGIC_TO_SPA);
+    output_queue.push(protocol::MSG_SETTINGS_REQUEST);
+    output_queue.push(payload[0]);
+    output_queue.push(payload[1]);
+    output_queue.push(payload[2]);
+    uint8_t attempt = discovery.attempts(request);
+    if (attempt > 1) {
+        ESP_LOGW(TAG, "No %s response, requesting again (attempt %u)", SpaDiscovery::name(request), attempt);
+    } else {
+        ESP_LOGD(TAG, "Requesting %s", SpaDiscovery::name(request));
+    }
+}
+
+void BalboaSpa::on_discovery_response(SpaDiscovery::Request request) {
+    discovery.on_response(request);
+    check_populated();
+    if (ready_ms == 0 && discovery.ready()) {
+        ready_ms = millis();
+        ESP_LOGI(TAG, "Discovery complete %u ms after boot", (unsigned) ready_ms);
+    }
+}
+
+void BalboaSpa::on_safe_shutdown() {
+    // Reboots and OTA updates keep the latest status, not the one from up to a persist interval ago
+    if (warm_start) {
+        save_warm_start(millis(), true);
+    }
+    // Energy and runtime since the last periodic write would be lost otherwise
+    save_energy_counters(millis(), true);
+    save_filter_counters(true);
+}
+
+uint16_t BalboaSpa::get_filter_counter_writes_today() const {
+    // The count only rolls over on a write, so a day without writes must not report the previous one
+    if (millis() - filter_counter_writes_day_start >= MS_PER_DAY) {
+        return 0;
+    }
+    return filter_counter_writes_today;
 }
 
 uint32_t BalboaSpa::get_filter1_current_runtime_minutes() const {
@@ -847,85 +1313,25 @@ uint32_t BalboaSpa::get_filter2_current_runtime_minutes() const {
 }
 
 void BalboaSpa::update_filter_status() {
-    uint32_t current_time = millis();
-    
-    // Optimized filter schedule checking with early returns
-    auto check_filter_schedule = [](uint8_t start_hour, uint8_t start_minute, 
-                                   uint8_t duration_hour, uint8_t duration_minute,
-                                   uint8_t current_hour, uint8_t current_minute) -> bool {
-        // Early return if no duration set
-        if (duration_hour == 0 && duration_minute == 0) {
-            return false;
-        }
-        
-        uint32_t current_minutes = current_hour * 60 + current_minute;
-        uint32_t filter_start_minutes = start_hour * 60 + start_minute;
-        uint32_t filter_duration_minutes = duration_hour * 60 + duration_minute;
-        
-        if (filter_duration_minutes == 0) {
-            return false;
-        }
-        
-        uint32_t end_minutes = filter_start_minutes + filter_duration_minutes;
-        
-        // Handle wrap around midnight
-        if (end_minutes > MINUTES_PER_DAY) {
-            return (current_minutes >= filter_start_minutes) || (current_minutes < (end_minutes - MINUTES_PER_DAY));
-        } else {
-            return (current_minutes >= filter_start_minutes) && (current_minutes < end_minutes);
-        }
-    };
-    
-    // Check filter schedules
-    bool filter1_should_run = check_filter_schedule(
-        spaFilterSettings.filter1_hour, spaFilterSettings.filter1_minute,
-        spaFilterSettings.filter1_duration_hour, spaFilterSettings.filter1_duration_minute,
-        spaState.hour, spaState.minutes
-    );
-    
-    bool filter2_should_run = false;
-    if (spaFilterSettings.filter2_enable) {
-        filter2_should_run = check_filter_schedule(
-            spaFilterSettings.filter2_hour, spaFilterSettings.filter2_minute,
-            spaFilterSettings.filter2_duration_hour, spaFilterSettings.filter2_duration_minute,
-            spaState.hour, spaState.minutes
-        );
+    FilterRuntimeUpdate update = update_filter_runtime(spaFilterSettings, millis(), spaState);
+    if (update.counters_changed) {
+        filter_counters_dirty = true;
     }
-    
-    // Update filter 1 status
-    if (filter1_should_run != spaState.filter1_running) {
-        if (filter1_should_run) {
-            // Filter 1 starting
-            spaState.filter1_running = true;
-            spaState.filter1_last_start_time = current_time;
-            ESP_LOGD(TAG, "Filter 1 started running");
-        } else {
-            // Filter 1 stopping
-            spaState.filter1_running = false;
-            uint32_t runtime_ms = current_time - spaState.filter1_last_start_time;
-            spaState.filter1_runtime_hours += runtime_ms / 3600000; // Convert to hours
-            spaState.filter1_cycles_completed++;
-            ESP_LOGD(TAG, "Filter 1 stopped running, total runtime: %d hours, cycles: %d", 
-                     spaState.filter1_runtime_hours, spaState.filter1_cycles_completed);
+    for (uint8_t i = 0; i < 2; i++) {
+        if (update.started[i]) {
+            ESP_LOGD(TAG, "Filter %d started running", i + 1);
         }
     }
-    
-    // Update filter 2 status
-    if (filter2_should_run != spaState.filter2_running) {
-        if (filter2_should_run) {
-            // Filter 2 starting
-            spaState.filter2_running = true;
-            spaState.filter2_last_start_time = current_time;
-            ESP_LOGD(TAG, "Filter 2 started running");
-        } else {
-            // Filter 2 stopping
-            spaState.filter2_running = false;
-            uint32_t runtime_ms = current_time - spaState.filter2_last_start_time;
-            spaState.filter2_runtime_hours += runtime_ms / 3600000; // Convert to hours
-            spaState.filter2_cycles_completed++;
-            ESP_LOGD(TAG, "Filter 2 stopped running, total runtime: %d hours, cycles: %d", 
-                     spaState.filter2_runtime_hours, spaState.filter2_cycles_completed);
-        }
+    if (update.stopped[0]) {
+        ESP_LOGD(TAG, "Filter 1 stopped running, total runtime: %.2f hours, cycles: %d",
+                 get_filter1_runtime_hours(), spaState.filter1_cycles_completed);
+    }
+    if (update.stopped[1]) {
+        ESP_LOGD(TAG, "Filter 2 stopped running, total runtime: %.2f hours, cycles: %d",
+                 get_filter2_runtime_hours(), spaState.filter2_cycles_completed);
+    }
+    if (update.stopped[0] || update.stopped[1]) {
+        save_filter_counters(true);
     }
 }
 
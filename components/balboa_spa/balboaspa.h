@@ -3,11 +3,34 @@
 #include "esphome/core/component.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/gpio.h"
+#ifdef USE_API
+#include "esphome/components/api/custom_api_device.h"
+#endif
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
 
 #include "spa_types.h"
 #include "spa_config.h"
 #include "spa_state.h"
+#include "spa_status.h"
+#include "spa_history.h"
+#include "heating_estimator.h"
+#include "energy_meter.h"
+#include "toggle_reconciler.h"
+#include "verified_write.h"
+#include "clock_sync.h"
+#include "echo_check.h"
+#include "bus_timing.h"
+#include "publish_limiter.h"
+#include "refresh_scheduler.h"
+#include "warm_start.h"
+#include "spa_discovery.h"
 #include "CircularBuffer.h"
+#include "balboa_protocol.h"
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -25,6 +48,26 @@ static const uint8_t ESPHOME_BALBOASPA_MIN_TEMPERATURE_F = 60;
 static const uint8_t ESPHOME_BALBOASPA_MAX_TEMPERATURE_F = 104;
 
 static const float   ESPHOME_BALBOASPA_POLLING_INTERVAL = 50; // frequency to poll uart device
+static const uint32_t ESPHOME_BALBOASPA_FILTER_PERSIST_INTERVAL_MS = 60 * 60 * 1000; // min time between filter counter flash writes
+static const uint32_t ESPHOME_BALBOASPA_ENERGY_UPDATE_INTERVAL_MS = 60 * 1000;        // how often energy sensors get new values
+static const uint32_t ESPHOME_BALBOASPA_ENERGY_PERSIST_INTERVAL_MS = 60 * 60 * 1000;  // min time between energy counter flash writes
+static const uint32_t ESPHOME_BALBOASPA_WARM_START_PERSIST_INTERVAL_MS = 60 * 60 * 1000;  // min time between status snapshot flash writes
+static const uint8_t ESPHOME_BALBOASPA_MAX_REFRESHES_PER_POLL = 2;                  // forced re-publishes per 50 ms poll
+
+// Item codes for the BF 11 toggle item message
+static const uint8_t TOGGLE_ITEM_PUMP1 = 0x04;
+static const uint8_t TOGGLE_ITEM_PUMP2 = 0x05;
+static const uint8_t TOGGLE_ITEM_PUMP3 = 0x06;
+static const uint8_t TOGGLE_ITEM_PUMP4 = 0x07;
+static const uint8_t TOGGLE_ITEM_PUMP5 = 0x08;
+static const uint8_t TOGGLE_ITEM_PUMP6 = 0x09;
+static const uint8_t TOGGLE_ITEM_BLOWER = 0x0C;
+static const uint8_t TOGGLE_ITEM_MISTER = 0x0E;
+static const uint8_t TOGGLE_ITEM_LIGHT1 = 0x11;
+static const uint8_t TOGGLE_ITEM_LIGHT2 = 0x12;
+static const uint8_t TOGGLE_ITEM_AUX1 = 0x16;
+static const uint8_t TOGGLE_ITEM_AUX2 = 0x17;
+static const uint8_t TOGGLE_ITEM_HIGH_RANGE = 0x50;
 
 #define STRON "ON"
 #define STROFF "OFF"
@@ -35,19 +78,36 @@ enum TEMP_SCALE : uint8_t {
   C = 1
 };
 
-class BalboaSpa : public uart::UARTDevice, public PollingComponent {
+class BalboaSpa : public uart::UARTDevice, public PollingComponent
+#ifdef USE_API
+                , public api::CustomAPIDevice
+#endif
+{
   public:
     BalboaSpa() : PollingComponent(ESPHOME_BALBOASPA_POLLING_INTERVAL) {}
     void setup() override;
+    void loop() override;
     void update() override;
+    void on_safe_shutdown() override;
+    void dump_config() override;
     float get_setup_priority() const override;
 
     SpaConfig get_current_config();
+    // A configuration restored by the warm start counts until the live one arrives
+    bool is_config_received() const { return discovery.received(SpaDiscovery::CONFIGURATION) || config_restored; }
+    // Everything counts as present until the configuration response says otherwise
+    bool has_equipment(uint16_t equipment) const { return spa_has_equipment(equipment_present, equipment); }
     SpaState* get_current_state();
 
     void set_temp(float temp);
     void set_hour(int hour);
     void set_minute(int minute);
+    void set_time(int hour, int minute);
+    // Switches the item on if it is off and off otherwise, through the reconciler like set_item_state()
+    void toggle_item(uint8_t item);
+    // Toggles the item until the status shows it on/off, or at the given level (0 off, 1 low, 2 high)
+    void set_item_state(uint8_t item, bool on);
+    void set_item_level(uint8_t item, uint8_t level);
     void toggle_light();
     void toggle_jet1();
     void toggle_jet2();
@@ -58,8 +118,42 @@ class BalboaSpa : public uart::UARTDevice, public PollingComponent {
 
     void set_spa_temp_scale(TEMP_SCALE scale);
     void set_esphome_temp_scale(TEMP_SCALE scale);
+    void set_filter_persist_interval(uint32_t interval_ms) { filter_persist_interval = interval_ms; }
+    void set_history_hours(uint8_t hours) { history_hours = hours; }
+    void set_toggle_retries(uint8_t retries) {
+      toggle_retries = retries;
+      toggle_reconciler.set_max_retries(retries);
+    }
+    void set_write_confirm_frames(uint8_t frames) {
+      write_confirm_frames = frames;
+      temperature_write.set_confirm_frames(frames);
+      clock_write.set_confirm_frames(frames);
+    }
+#ifdef USE_TIME
+    void set_time_source(time::RealTimeClock *time) { time_source = time; }
+#endif
+    void set_clock_sync_threshold(uint32_t seconds) { clock_sync.set_threshold(seconds); }
+    void set_clock_sync_interval(uint32_t interval_ms) { clock_sync.set_min_interval(interval_ms); }
+    void set_write_retries(uint8_t retries) {
+      write_retries = retries;
+      temperature_write.set_max_retries(retries);
+      clock_write.set_max_retries(retries);
+    }
+    void set_echo_check(bool enabled) { echo_check.set_enabled(enabled); }
+    void set_flow_control_pin(GPIOPin *pin) { flow_control_pin = pin; }
+    void set_load_power(SpaLoad load, uint8_t speed, float watts) { energy_meter.set_power(load, speed, watts); }
+    void set_energy_update_interval(uint32_t interval_ms) { energy_update_interval = interval_ms; }
+    void set_energy_persist_interval(uint32_t interval_ms) { energy_persist_interval = interval_ms; }
+    void set_refresh_interval(uint32_t interval_ms) { refresh_scheduler.set_interval(interval_ms); }
+    void set_warm_start(uint32_t persist_interval_ms) {
+      warm_start = true;
+      warm_start_persist_interval = persist_interval_ms;
+    }
+
+    // Per-minute temperature/heater/pump history, empty unless history_hours is set
+    const SpaHistory &get_history() const { return history; }
 
-    bool is_communicating();
+    bool is_communicating() const;
     bool is_filter1_enabled() const { return true; } // Filter 1 is always enabled
     bool is_filter2_enabled() const { return spaFilterSettings.filter2_enable == 1; }
     
@@ -86,12 +180,68 @@ class BalboaSpa : public uart::UARTDevice, public PollingComponent {
     // Filter status methods
     bool is_filter1_running() const { return spaState.filter1_running; }
     bool is_filter2_running() const { return spaState.filter2_running; }
-    uint16_t get_filter1_runtime_hours() const { return spaState.filter1_runtime_hours; }
-    uint16_t get_filter2_runtime_hours() const { return spaState.filter2_runtime_hours; }
+    // Hours are derived from the seconds counter in 0.01 h (36 s) steps
+    float get_filter1_runtime_hours() const { return (spaState.filter1_runtime_seconds / 36) / 100.0f; }
+    float get_filter2_runtime_hours() const { return (spaState.filter2_runtime_seconds / 36) / 100.0f; }
     uint16_t get_filter1_cycles_completed() const { return spaState.filter1_cycles_completed; }
     uint16_t get_filter2_cycles_completed() const { return spaState.filter2_cycles_completed; }
     uint32_t get_filter1_current_runtime_minutes() const;
     uint32_t get_filter2_current_runtime_minutes() const;
+    uint16_t get_filter_counter_writes_today() const;
+
+    // Heating estimates, in the ESPHome temperature unit; NAN until enough steps were seen
+    float get_heating_rate() const { return heating_estimator.heating_rate(); }
+    float get_cooling_rate() const { return heating_estimator.cooling_rate(); }
+    float get_minutes_to_target() const { return heating_estimator.minutes_to_target(spaState.current_temp, spaState.target_temp); }
+
+    // Convergence time and retry counts of toggle reconciliation
+    const ToggleReconciler &get_toggle_reconciler() const { return toggle_reconciler; }
+
+    // Set temperature and clock writes, summed over both
+    uint32_t get_writes_confirmed() const { return temperature_write.confirmed() + clock_write.confirmed(); }
+    uint32_t get_writes_retried() const { return temperature_write.retried() + clock_write.retried(); }
+    uint32_t get_writes_abandoned() const { return temperature_write.abandoned() + clock_write.abandoned(); }
+
+    // Spa clock against the linked time source; NAN without one
+    float get_clock_error() const { return clock_sync.error_seconds(); }
+    float get_clock_drift() const { return clock_sync.drift_seconds_per_day(); }
+
+    // Bus resynchronization: bytes discarded after corrupted frames, duration of the last recovery
+    uint32_t get_bytes_lost() const { return parser.stats().bytes_lost; }
+
+    // Rejected frames by reason
+    uint32_t get_crc_errors() const { return parser.stats().crc_errors; }
+    uint32_t get_oversized_frames() const { return parser.stats().oversized; }
+    uint32_t get_truncated_frames() const { return parser.stats().truncated; }
+    // Includes length bytes too small for any frame
+    uint32_t get_short_frames() const { return parser.stats().undersized + frames_too_short; }
+    uint32_t get_long_frames() const { return frames_too_long; }
+    uint32_t get_last_resync_ms() const { return last_resync_ms; }
+
+    // Echo check: our frames corrupted on the bus, and how many were sent again
+    uint32_t get_bus_collisions() const { return echo_check.collisions(); }
+    uint32_t get_bus_retransmits() const { return echo_check.retransmits(); }
+
+    // Receive timing: frame gaps, status and clear-to-send periods, our reply latency
+    const BusTiming &get_bus_timing() const { return bus_timing; }
+
+    // Time from boot to the first live status frame, and until configuration and filter settings also came in; NAN until then
+    float get_boot_to_first_state_ms() const { return first_state_ms == 0 ? NAN : first_state_ms; }
+    float get_boot_to_populated_ms() const { return populated_ms == 0 ? NAN : populated_ms; }
+    // Time from boot until every discovery request was answered; NAN until then
+    float get_boot_to_ready_ms() const { return ready_ms == 0 ? NAN : ready_ms; }
+    // Resends per discovery request since boot
+    uint32_t get_discovery_retries(SpaDiscovery::Request request) const { return discovery.retries(request); }
+
+    // Driver enable held past the last stop bit, smoothed over recent frames; NAN without a flow control pin
+    float get_bus_turnaround_us() const { return turnaround_samples == 0 ? NAN : turnaround_us; }
+
+    // Minimum publish intervals and deadbands; entities register their slots from set_publish_limit()
+    PublishLimiter &get_publish_limiter() { return publish_limiter; }
+    const PublishLimiter &get_publish_limiter() const { return publish_limiter; }
+
+    // Energy totals, refreshed every energy update interval
+    const SpaEnergyMeter &get_energy_meter() const { return energy_meter; }
 
     // Debug methods for pump status
     uint8_t get_pump_status_byte() const { return last_pump_status_byte; }
@@ -102,19 +252,30 @@ class BalboaSpa : public uart::UARTDevice, public PollingComponent {
 
 
 
-    void register_listener(const std::function<void(SpaState*)> &func) {this->listeners_.push_back(func);}
+    // entity_size is only used for the memory footprint report in dump_config().
+    // Listeners tied to equipment the spa does not have are not called.
+    void register_listener(const std::function<void(SpaState*)> &func, size_t entity_size = 0,
+                           uint16_t equipment = EQUIPMENT_NONE) {
+      this->listeners_.push_back({func, equipment});
+      this->entity_bytes_ += entity_size;
+    }
+
+    // Forced re-publish, spread over the refresh interval instead of all entities at once
+    void register_refresh(RefreshScheduler::Callback callback) { refresh_scheduler.add(std::move(callback)); }
 
   private:
-    CircularBuffer<uint8_t, 100> input_queue;
+    protocol::FrameParser parser;
     CircularBuffer<uint8_t, 100> output_queue;
     uint8_t received_byte, loop_index, temp_index;
     uint8_t last_state_crc = 0x00;
     uint8_t send_command = 0x00;
-    uint8_t target_temperature = 0x00;
-    uint8_t target_hour = 0x00;
-    uint8_t target_minute = 0x00;
     uint8_t client_id = 0x00;
     uint32_t last_received_time = 0;
+    bool resyncing = false;
+    uint32_t resync_started = 0;  // millis() of the first rejected frame
+    uint32_t last_resync_ms = 0;
+    uint32_t frames_too_short = 0;  // valid CRC, payload shorter than its type allows
+    uint32_t frames_too_long = 0;
     uint32_t last_filtersettings_request = 0;  // Track last filter settings request time
     uint8_t last_pump_status_byte = 0x00;  // Store the raw pump status byte
     uint8_t last_status_byte_16 = 0x00;    // Store status byte 16
@@ -128,32 +289,131 @@ class BalboaSpa : public uart::UARTDevice, public PollingComponent {
     float convert_c_to_f(float c);
     float convert_f_to_c(float f);
 
-    std::vector<std::function<void(SpaState*)>> listeners_;
+    struct SpaListener {
+      std::function<void(SpaState*)> callback;
+      uint16_t equipment;
+    };
+    std::vector<SpaListener> listeners_;
+    size_t entity_bytes_ = 0;
 
-    char config_request_status = 0; //stages: 0-> want it; 1-> requested it; 2-> got it; 3-> further processed it
-    char faultlog_request_status = 0; //stages: 0-> want it; 1-> requested it; 2-> got it; 3-> further processed it
-    char filtersettings_request_status = 0; //stages: 0-> want it; 1-> requested it; 2-> got it; 3-> further processed it
-    char faultlog_update_timer = 0; //temp logic so we only get the fault log once per 5 minutes
-    char filtersettings_update_timer = 0; //temp logic so we only get the filter settings once per 5 minutes
+    // Configuration, filter cycles, information, preferences and fault log requests after a client ID was assigned
+    SpaDiscovery discovery;
+    uint32_t ready_ms = 0;  // millis() once every request was answered
+    void send_discovery_request(SpaDiscovery::Request request);
+    void on_discovery_response(SpaDiscovery::Request request);
 
     SpaConfig spaConfig;
+    uint16_t equipment_present = EQUIPMENT_ALL;
     SpaState spaState;
     SpaFaultLog spaFaultLog;
     SpaFilterSettings spaFilterSettings;
 
+    // Filter counter persistence; writes are coalesced to limit flash wear
+    ESPPreferenceObject filter_counters_pref;
+    uint32_t filter_persist_interval = ESPHOME_BALBOASPA_FILTER_PERSIST_INTERVAL_MS;
+    bool filter_counters_dirty = false;
+    uint32_t last_filter_counters_save = 0;
+    uint32_t filter_counter_writes_day_start = 0;
+    uint16_t filter_counter_writes_today = 0;
+
+    HeatingRateEstimator heating_estimator;
+
+    ToggleReconciler toggle_reconciler;
+    uint8_t toggle_retries = 3;
+
+    // Set temperature (raw spa units) and clock (minutes of day), resent until the status shows them
+    VerifiedWrite temperature_write;
+    VerifiedWrite clock_write;
+    bool clock_write_exact = false;
+    bool filter_schedule_write_due = false;  // set_filter*_schedule() waiting for a clear-to-send  // a sync sets the minute at second 0, so only that minute confirms it
+    uint8_t write_confirm_frames = 5;
+    uint8_t write_retries = 3;
+
+    SpaClockSync clock_sync;
+    bool spa_clock_known = false;
+
+    EchoCheck echo_check;
+    void check_echo_timeout();
+
+    // RS-485 driver enable (DE/RE), high only while we transmit
+    GPIOPin *flow_control_pin = nullptr;
+    float turnaround_us = 0;
+    uint32_t turnaround_samples = 0;
+    void transmit(const uint8_t *frame, size_t frame_size);
+
+    // Warm start: the last client ID, configuration, filter settings and status, kept in flash.
+    // A restored client ID is used right away but dropped if no clear-to-send confirms it.
+    bool warm_start = false;
+    uint32_t warm_start_persist_interval = ESPHOME_BALBOASPA_WARM_START_PERSIST_INTERVAL_MS;
+    ESPPreferenceObject warm_start_pref;
+    SpaWarmStart warm_start_saved{};
+    uint32_t last_warm_start_save = 0;
+    bool warm_start_identity_dirty = false;  // client ID, configuration or filter settings changed
+    bool client_id_restored = false;         // not yet confirmed by a clear-to-send
+    bool config_restored = false;
+    bool filter_settings_restored = false;
+    uint32_t first_state_ms = 0;  // millis() of the first live status frame
+    uint32_t populated_ms = 0;    // millis() once state, configuration and filter settings were live
+    void restore_warm_start();
+    void save_warm_start(uint32_t now, bool force);
+    void check_populated();
+
+    PublishLimiter publish_limiter;
+    RefreshScheduler refresh_scheduler;
+
+    BusTiming bus_timing;
+    uint32_t last_bus_timing_log = 0;
+    void log_bus_timing();
+#ifdef USE_TIME
+    time::RealTimeClock *time_source = nullptr;
+    void observe_spa_clock_tick(uint8_t hour, uint8_t minute);
+    void sync_clock(uint32_t now);
+#endif
+
+    // Energy metering from nameplate power; saved with the same coalescing as the filter counters
+    SpaEnergyMeter energy_meter;
+    ESPPreferenceObject energy_pref;
+    uint32_t energy_update_interval = ESPHOME_BALBOASPA_ENERGY_UPDATE_INTERVAL_MS;
+    uint32_t energy_persist_interval = ESPHOME_BALBOASPA_ENERGY_PERSIST_INTERVAL_MS;
+    uint32_t last_energy_tick = 0;
+    uint32_t last_energy_snapshot = 0;
+    uint32_t last_energy_save = 0;
+    bool energy_dirty = false;
+
+    // On-device history, sampled once per second from update()
+    SpaHistory history;
+    uint8_t history_hours = 0;
+    uint32_t last_history_sample = 0;
+
     void read_serial();
+    void handle_frame(protocol::ByteSpan frame);
+    void restore_filter_counters();
+    void save_filter_counters(bool force);
+    void log_memory_footprint();
+    void sample_history(uint32_t now);
+    void restore_energy_counters();
+    void update_energy(uint32_t now);
+    void save_energy_counters(uint32_t now, bool force);
+    void confirm_writes(const protocol::StatusMessage &status);
+    void request_clock(uint16_t minute_of_day, bool exact);
+    void queue_filter_schedule();
+#ifdef USE_API
+    void on_history_request(int minutes);
+#endif
     void update_sensors();
     void update_filter_status();
 
-    uint8_t crc8(CircularBuffer<uint8_t, 100> &data, bool ignore_delimiter);
     void ID_request();
     void ID_ack();
     void rs485_send();
-    void print_msg(CircularBuffer<uint8_t, 100> &data);
-    void decodeSettings();
-    void decodeState();
-    void decodeFilterSettings();
-    void decodeFault();
+    void print_msg(protocol::ByteSpan data);
+    void decodeSettings(const protocol::ConfigMessage &config);
+    void apply_config();
+    void decodeState(protocol::ByteSpan frame, const protocol::StatusMessage &status);
+    void decodeFilterSettings(const protocol::FilterCyclesMessage &filters);
+    void decodeFault(const protocol::FaultLogMessage &fault);
+    void decodeInformation(const protocol::InformationMessage &info);
+    void decodePreferences(const protocol::PreferencesMessage &prefs);
 };
 
 
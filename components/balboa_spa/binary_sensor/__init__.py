@@ -5,7 +5,9 @@ from esphome.components import binary_sensor
 from .. import (
     balboa_spa_ns,
     BalboaSpa,
-    CONF_SPA_ID
+    CONF_MIN_PUBLISH_INTERVAL,
+    CONF_SPA_ID,
+    PUBLISH_INTERVAL_SCHEMA,
 )
 
 from esphome.const import (
@@ -33,86 +35,96 @@ CONF_PUMP1_RUNNING = "pump1_running"
 CONF_PUMP2_RUNNING = "pump2_running"
 CONF_PUMP3_RUNNING = "pump3_running"
 
+# One entry per row of BALBOA_SPA_BINARY_SENSOR_TYPES in binary_sensors.h; the key upper-cased is the row name
+BINARY_SENSOR_TYPES = {
+    CONF_BLOWER: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_HIGHRANGE: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_CIRCULATION: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_RESTMODE: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_HEATSTATE: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_CONNECTED: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:lan-connect",
+        device_class=DEVICE_CLASS_CONNECTIVITY,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_FILTER1_ACTIVE: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:filter",
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_FILTER2_ACTIVE: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:filter",
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_FILTER1_RUNNING: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:filter-variant",
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_FILTER2_RUNNING: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:filter-variant",
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_PUMP1_RUNNING: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:pump",
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_PUMP2_RUNNING: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:pump",
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+    CONF_PUMP3_RUNNING: binary_sensor.binary_sensor_schema(
+        SpaSensor,
+        icon="mdi:pump",
+        device_class=DEVICE_CLASS_POWER,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+    ),
+}
+
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(CONF_SPA_ID): cv.use_id(BalboaSpa),
-        cv.Optional(CONF_BLOWER): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_HIGHRANGE): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_CIRCULATION): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_RESTMODE): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_HEATSTATE): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_CONNECTED): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:lan-connect",
-            device_class=DEVICE_CLASS_CONNECTIVITY,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_FILTER1_ACTIVE): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:filter",
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_FILTER2_ACTIVE): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:filter",
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_FILTER1_RUNNING): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:filter-variant",
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_FILTER2_RUNNING): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:filter-variant",
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_PUMP1_RUNNING): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:pump",
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_PUMP2_RUNNING): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:pump",
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
-        cv.Optional(CONF_PUMP3_RUNNING): binary_sensor.binary_sensor_schema(
-            SpaSensor,
-            icon="mdi:pump",
-            device_class=DEVICE_CLASS_POWER,
-            entity_category=ENTITY_CATEGORY_DIAGNOSTIC
-        ),
+    }).extend({
+        # The connection state is always published at once
+        cv.Optional(sensor_type): schema if sensor_type == CONF_CONNECTED else schema.extend(PUBLISH_INTERVAL_SCHEMA)
+        for sensor_type, schema in BINARY_SENSOR_TYPES.items()
     })
 
 async def to_code(config):
     parent = await cg.get_variable(config[CONF_SPA_ID])
 
-    for sensor_type in [CONF_BLOWER, CONF_HIGHRANGE, CONF_CIRCULATION, CONF_RESTMODE, CONF_HEATSTATE, CONF_CONNECTED, CONF_FILTER1_ACTIVE, CONF_FILTER2_ACTIVE, CONF_FILTER1_RUNNING, CONF_FILTER2_RUNNING, CONF_PUMP1_RUNNING, CONF_PUMP2_RUNNING, CONF_PUMP3_RUNNING]:
+    for sensor_type in BINARY_SENSOR_TYPES:
         if conf := config.get(sensor_type):
             var = await binary_sensor.new_binary_sensor(conf)
             cg.add(var.set_parent(parent))
-            sensor_type_value = getattr(SpaSensorTypeEnum, sensor_type.upper()) if hasattr(SpaSensorTypeEnum, sensor_type.upper()) else sensor_type
+            sensor_type_value = getattr(SpaSensorTypeEnum, sensor_type.upper())
             cg.add(var.set_sensor_type(sensor_type_value))
+            if CONF_MIN_PUBLISH_INTERVAL in conf and conf[CONF_MIN_PUBLISH_INTERVAL].total_milliseconds > 0:
+                cg.add(var.set_publish_limit(conf[CONF_MIN_PUBLISH_INTERVAL]))
@@ -6,93 +6,99 @@ namespace balboa_spa {
 
 static const char *TAG = "BalboaSpa.binary_sensors";
 
+using BinaryAccessor = BalboaSpaBinarySensors::Accessor;
+
+// One accessor per BalboaSpaBinarySensorType, indexed by the enum value
+#define BALBOA_SPA_BINARY_SENSOR_ACCESSOR(name, ...) __VA_ARGS__,
+static const BinaryAccessor BINARY_SENSOR_ACCESSORS[] = {
+    nullptr,  // UNKNOWN
+    BALBOA_SPA_BINARY_SENSOR_TYPES(BALBOA_SPA_BINARY_SENSOR_ACCESSOR)
+};
+#undef BALBOA_SPA_BINARY_SENSOR_ACCESSOR
+
 void BalboaSpaBinarySensors::set_parent(BalboaSpa *parent) {
     this->spa = parent;
-    parent->register_listener([this](SpaState* spaState){ this->update(spaState); });
+    parent->register_listener([this](SpaState* spaState){ this->update(spaState); }, sizeof(*this));
+    parent->register_refresh([this]() { this->refresh(); });
+}
+
+void BalboaSpaBinarySensors::set_sensor_type(const BalboaSpaBinarySensorType _type) {
+    sensor_type = _type;
+    auto index = static_cast<uint8_t>(_type);
+    accessor = index < static_cast<uint8_t>(BalboaSpaBinarySensorType::BINARY_SENSOR_TYPE_COUNT) ? BINARY_SENSOR_ACCESSORS[index] : nullptr;
+    if (accessor == nullptr) {
+        ESP_LOGW(TAG, "Unknown binary sensor type: %d", index);
+    }
+}
+
+void BalboaSpaBinarySensors::set_publish_limit(uint32_t min_interval_ms) {
+    limit_slot = spa->get_publish_limiter().add(min_interval_ms, 0);
 }
 
 void BalboaSpaBinarySensors::update(SpaState* spaState) {
-    bool sensor_state_value;
-    
+    if (accessor == nullptr || spa == nullptr) {
+        return;
+    }
+
     // Handle communication status sensor separately
     if (sensor_type == BalboaSpaBinarySensorType::CONNECTED) {
-        sensor_state_value = spa->is_communicating();
-        if(this->state != sensor_state_value) {
-            this->publish_state(sensor_state_value);
+        bool connected = spa->is_communicating();
+        if(this->state != connected) {
+            this->publish_state(connected);
         }
         return;
     }
-    
-    // Early return if spa is null or not communicating for other sensors
-    if (spa == nullptr || !spa->is_communicating()) {
+
+    // Early return if not communicating for other sensors
+    if (!spa->is_communicating()) {
+        return;
+    }
+
+    uint8_t state_value = accessor(*spa, *spaState);
+    if (state_value == NO_VALUE) {
         return;
     }
+    bool sensor_state_value = state_value;
 
-    uint8_t state_value = 0;
-    switch (sensor_type)
-    {
-        case BalboaSpaBinarySensorType::BLOWER:
-            sensor_state_value = spaState->blower;
-            break;
-        case BalboaSpaBinarySensorType::HIGHRANGE:
-            sensor_state_value = spaState->highrange;
-            break;
-        case BalboaSpaBinarySensorType::CIRCULATION:
-            sensor_state_value = spaState->circulation;
-            break;
-        case BalboaSpaBinarySensorType::RESTMODE:
-            state_value = spaState->rest_mode;
-            sensor_state_value = state_value;
-            if(state_value == 254) {
-                // This indicate no value
-                return;
-            }
-            break;
-        case BalboaSpaBinarySensorType::HEATSTATE:
-            state_value = spaState->heat_state;
-            sensor_state_value = state_value;
-            if(state_value == 254) {
-                // no value
-                return;
-            }
-            break;
-        case BalboaSpaBinarySensorType::FILTER1_ACTIVE:
-            sensor_state_value = spa->is_filter1_enabled();
-            break;
-        case BalboaSpaBinarySensorType::FILTER2_ACTIVE:
-            sensor_state_value = spa->is_filter2_enabled();
-            break;
-        case BalboaSpaBinarySensorType::FILTER1_RUNNING:
-            sensor_state_value = spa->is_filter1_running();
-            break;
-        case BalboaSpaBinarySensorType::FILTER2_RUNNING:
-            sensor_state_value = spa->is_filter2_running();
-            break;
-        case BalboaSpaBinarySensorType::PUMP1_RUNNING:
-            sensor_state_value = (spaState->pump1 > 0);  // Running if not 0 (off)
-            break;
-        case BalboaSpaBinarySensorType::PUMP2_RUNNING:
-            sensor_state_value = (spaState->pump2 > 0);  // Running if not 0 (off)
-            break;
-        case BalboaSpaBinarySensorType::PUMP3_RUNNING:
-            sensor_state_value = (spaState->pump3 > 0);  // Running if not 0 (off)
-            break;
-        default:
-            ESP_LOGD(TAG, "Unknown binary sensor type: %d", sensor_type);
-            return;
+    if (limit_slot != PublishLimiter::NO_SLOT) {
+        if (spa->get_publish_limiter().check_value(limit_slot, sensor_state_value, millis())) {
+            this->publish_state(sensor_state_value);
+        }
+        return;
     }
 
-    // Only publish if state has changed or forced update interval
-    if(this->state != sensor_state_value || this->last_update_time + 300000 < millis()) {
+    // Only publish if state has changed
+    if(this->state != sensor_state_value) {
         this->publish_state(sensor_state_value);
-        last_update_time = millis();
     }
 }
 
+void BalboaSpaBinarySensors::refresh() {
+    if (accessor == nullptr || spa == nullptr) {
+        return;
+    }
+    if (sensor_type == BalboaSpaBinarySensorType::CONNECTED) {
+        this->publish_state(spa->is_communicating());
+        return;
+    }
+    if (!spa->is_communicating()) {
+        return;
+    }
+
+    // The current value, not the last published one, so a change held back by a publish limit goes out too
+    uint8_t state_value = accessor(*spa, *spa->get_current_state());
+    if (state_value == NO_VALUE) {
+        return;
+    }
+    bool value = state_value;
+    this->publish_state(value);
+    spa->get_publish_limiter().published(limit_slot, value, millis());
+}
+
 BalboaSpaBinarySensors::BalboaSpaBinarySensors() {
     spa = nullptr;
     sensor_type = BalboaSpaBinarySensorType::UNKNOWN;
-    last_update_time = 0;
+    accessor = nullptr;
 }
 
 }}
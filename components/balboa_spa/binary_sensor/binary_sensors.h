@@ -8,36 +8,56 @@
 namespace esphome {
 namespace balboa_spa {
 
+// Every binary sensor type and how its value is read, in enum order; the enum and the accessor
+// table are both expanded from this list, so they cannot drift apart. To add a binary sensor, add
+// a row here and a schema in binary_sensor/__init__.py whose key upper-cased is the name.
+// rest_mode and heat_state pass through 254 from SpaState, which doubles as NO_VALUE; pumps run
+// at any level but 0 (off).
+#define BALBOA_SPA_BINARY_SENSOR_TYPES(X) \
+  X(BLOWER, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.blower; }) \
+  X(HIGHRANGE, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.highrange; }) \
+  X(CIRCULATION, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.circulation; }) \
+  X(RESTMODE, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.rest_mode; }) \
+  X(HEATSTATE, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.heat_state; }) \
+  X(CONNECTED, [](const BalboaSpa &spa, const SpaState &) -> uint8_t { return spa.is_communicating(); }) \
+  X(FILTER1_ACTIVE, [](const BalboaSpa &spa, const SpaState &) -> uint8_t { return spa.is_filter1_enabled(); }) \
+  X(FILTER2_ACTIVE, [](const BalboaSpa &spa, const SpaState &) -> uint8_t { return spa.is_filter2_enabled(); }) \
+  X(FILTER1_RUNNING, [](const BalboaSpa &spa, const SpaState &) -> uint8_t { return spa.is_filter1_running(); }) \
+  X(FILTER2_RUNNING, [](const BalboaSpa &spa, const SpaState &) -> uint8_t { return spa.is_filter2_running(); }) \
+  X(PUMP1_RUNNING, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.pump1 > 0; }) \
+  X(PUMP2_RUNNING, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.pump2 > 0; }) \
+  X(PUMP3_RUNNING, [](const BalboaSpa &, const SpaState &s) -> uint8_t { return s.pump3 > 0; })
+
 class BalboaSpaBinarySensors : public binary_sensor::BinarySensor {
 public:
-  enum class BalboaSpaBinarySensorType : uint8_t{
+#define BALBOA_SPA_BINARY_SENSOR_ENUM(name, ...) name,
+  enum class BalboaSpaBinarySensorType : uint8_t {
     UNKNOWN = 0,
-    BLOWER,
-    HIGHRANGE,
-    CIRCULATION,
-    RESTMODE,
-    HEATSTATE,
-    CONNECTED,
-    FILTER1_ACTIVE,
-    FILTER2_ACTIVE,
-    FILTER1_RUNNING,
-    FILTER2_RUNNING,
-    PUMP1_RUNNING,
-    PUMP2_RUNNING,
-    PUMP3_RUNNING
+    BALBOA_SPA_BINARY_SENSOR_TYPES(BALBOA_SPA_BINARY_SENSOR_ENUM)
+    BINARY_SENSOR_TYPE_COUNT  // keep last, sizes the accessor table
   };
+#undef BALBOA_SPA_BINARY_SENSOR_ENUM
+
+  // Reads one value out of the spa; returns NO_VALUE when there is nothing to publish
+  using Accessor = uint8_t (*)(const BalboaSpa &spa, const SpaState &spaState);
+  static const uint8_t NO_VALUE = 254;
 
 public:
   BalboaSpaBinarySensors();
   void update(SpaState* spaState);
+  // Re-publishes the current value, called by the parent's refresh scheduler
+  void refresh();
 
   void set_parent(BalboaSpa *parent);
-  void set_sensor_type(const BalboaSpaBinarySensorType _type) { sensor_type = _type;  }
+  void set_sensor_type(const BalboaSpaBinarySensorType _type);
+  // Call after set_parent(); the parent applies the limit
+  void set_publish_limit(uint32_t min_interval_ms);
 
   private:
     BalboaSpaBinarySensorType sensor_type;
+    Accessor accessor;
     BalboaSpa *spa;
-    uint32_t last_update_time;
+    PublishLimiter::Slot limit_slot = PublishLimiter::NO_SLOT;
 };
 
 }  // namespace balboa_spa
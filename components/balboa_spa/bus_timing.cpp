@@ -0,0 +1,86 @@
+#include "bus_timing.h"
+
+#include "balboa_protocol.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+// Covers one byte time at 115200 baud up to the ~1 s status period
+const uint32_t GapHistogram::UPPER_BOUNDS_US[GapHistogram::BUCKET_COUNT - 1] = {
+    100, 200, 500, 1000, 2000, 5000, 10000, 50000, 200000,
+};
+
+static const float SMOOTHING = 0.125f;  // weight of the newest sample in the averages
+
+void GapHistogram::add(uint32_t us) {
+    uint8_t bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && us >= UPPER_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    counts[bucket]++;
+}
+
+uint32_t GapHistogram::total() const {
+    uint32_t sum = 0;
+    for (uint32_t count : counts) {
+        sum += count;
+    }
+    return sum;
+}
+
+uint32_t GapHistogram::percentile_us(float fraction) const {
+    uint32_t target = total() * fraction;
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        seen += counts[bucket];
+        if (seen > target) {
+            return bucket == 0 ? 0 : UPPER_BOUNDS_US[bucket - 1];
+        }
+    }
+    return 0;
+}
+
+void BusTiming::smooth(float &average, float sample) {
+    average = std::isnan(average) ? sample : average + (sample - average) * SMOOTHING;
+}
+
+void BusTiming::on_frame(uint32_t end_us, size_t size, uint8_t channel, uint8_t type, uint8_t client_id) {
+    uint32_t start_us = end_us - static_cast<uint32_t>(size * byte_time_us_);
+
+    // Unsigned differences stay correct across the ~71 minute micros() wrap
+    if (have_frame_) {
+        int32_t gap = static_cast<int32_t>(start_us - last_end_us_);
+        gaps_.add(gap > 0 ? gap : 0);
+    }
+    have_frame_ = true;
+    last_end_us_ = end_us;
+    awaiting_reply_ = false;
+
+    if (channel == protocol::CHANNEL_BROADCAST && type == protocol::MSG_STATUS) {
+        if (have_status_) {
+            smooth(status_period_ms_, (start_us - last_status_us_) / 1000.0f);
+        }
+        have_status_ = true;
+        last_status_us_ = start_us;
+    } else if (client_id != 0 && channel == client_id && type == protocol::MSG_CLEAR_TO_SEND) {
+        if (have_cts_) {
+            smooth(cts_period_ms_, (start_us - last_cts_us_) / 1000.0f);
+        }
+        have_cts_ = true;
+        last_cts_us_ = start_us;
+        awaiting_reply_ = true;
+    }
+}
+
+void BusTiming::on_transmit(uint32_t start_us) {
+    if (!awaiting_reply_) {
+        return;
+    }
+    awaiting_reply_ = false;
+    uint32_t latency = start_us - last_end_us_;
+    reply_latency_.add(latency);
+    smooth(reply_latency_us_, latency);
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cmath>
+
+namespace esphome {
+namespace balboa_spa {
+
+// Counts of durations in fixed microsecond buckets; the last bucket is open-ended
+struct GapHistogram {
+    static const uint8_t BUCKET_COUNT = 10;
+    static const uint32_t UPPER_BOUNDS_US[BUCKET_COUNT - 1];
+
+    uint32_t counts[BUCKET_COUNT] = {};
+
+    void add(uint32_t us);
+    uint32_t total() const;
+    // Lower edge of the bucket holding the given fraction of samples; 0 when empty
+    uint32_t percentile_us(float fraction) const;
+};
+
+/**
+ * Receive-side timing of the bus: gaps between frames, the period of status
+ * broadcasts and of our clear-to-send polls, and how long we take to answer.
+ *
+ * Frames are stamped when their last byte is read. Since the mainboard sends
+ * a frame's bytes back to back, the first byte's time is derived from the
+ * frame length and the byte time at the UART baud rate. Stamps are only as
+ * precise as the component drains the UART, so they are taken in loop().
+ */
+class BusTiming {
+  public:
+    void set_byte_time_us(float us) { byte_time_us_ = us; }
+
+    // A valid frame whose last byte was read at end_us
+    void on_frame(uint32_t end_us, size_t size, uint8_t channel, uint8_t type, uint8_t client_id);
+    // We started sending at start_us
+    void on_transmit(uint32_t start_us);
+
+    const GapHistogram &gaps() const { return gaps_; }
+    const GapHistogram &reply_latency() const { return reply_latency_; }
+    // Smoothed periods in milliseconds; NAN until two frames of the kind were seen
+    float status_period_ms() const { return status_period_ms_; }
+    float cts_period_ms() const { return cts_period_ms_; }
+    // Smoothed time from the end of our clear-to-send to our first byte; NAN before the first reply
+    float reply_latency_us() const { return reply_latency_us_; }
+
+  private:
+    static void smooth(float &average, float sample);
+
+    float byte_time_us_ = 1e6f / 11520;  // 115200 baud, 10 bits per byte
+    bool have_frame_ = false;
+    uint32_t last_end_us_ = 0;
+    bool have_status_ = false;
+    uint32_t last_status_us_ = 0;
+    bool have_cts_ = false;
+    uint32_t last_cts_us_ = 0;
+    bool awaiting_reply_ = false;
+
+    GapHistogram gaps_;
+    GapHistogram reply_latency_;
+    float status_period_ms_ = NAN;
+    float cts_period_ms_ = NAN;
+    float reply_latency_us_ = NAN;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
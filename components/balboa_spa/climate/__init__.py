@@ -4,7 +4,9 @@ from esphome.components import climate
 from esphome.const import CONF_ID
 
 from .. import (
+    CONF_MIN_PUBLISH_INTERVAL,
     CONF_SPA_ID,
+    PUBLISH_INTERVAL_SCHEMA,
     balboa_spa_ns,
     BalboaSpa,
 )
@@ -19,7 +21,7 @@ CONFIG_SCHEMA = (
     {
         cv.GenerateID(): cv.declare_id(BalboaSpaThermostat),
         cv.GenerateID(CONF_SPA_ID): cv.use_id(BalboaSpa),
-    })
+    }).extend(PUBLISH_INTERVAL_SCHEMA)
 )
 
 async def to_code(config):
@@ -30,3 +32,5 @@ async def to_code(config):
 
     parent = await cg.get_variable(config[CONF_SPA_ID])
     cg.add(var.set_parent(parent))
+    if config[CONF_MIN_PUBLISH_INTERVAL].total_milliseconds > 0:
+        cg.add(var.set_publish_limit(config[CONF_MIN_PUBLISH_INTERVAL]))
@@ -37,7 +37,12 @@ climate::ClimateTraits BalboaSpaThermostat::traits()
 
 void BalboaSpaThermostat::set_parent(BalboaSpa *parent) {
     spa = parent;
-    parent->register_listener([this](SpaState* spaState){ this->update(spaState); });
+    parent->register_listener([this](SpaState* spaState){ this->update(spaState); }, sizeof(*this));
+    parent->register_refresh([this]() { this->refresh(); });
+}
+
+void BalboaSpaThermostat::set_publish_limit(uint32_t min_interval_ms) {
+    limit_slot = spa->get_publish_limiter().add(min_interval_ms, 0);
 }
 
 bool inline is_diff_no_nan(float a, float b){
@@ -108,16 +113,24 @@ void BalboaSpaThermostat::update(SpaState* spaState) {
         needs_update = true;
     }
 
-    // Force update every 5 minutes to ensure Home Assistant stays in sync
-    if (this->last_update_time + 300000 < millis()) {
-        needs_update = true;
+    if (limit_slot != PublishLimiter::NO_SLOT) {
+        // Changes are held until the interval elapses, then sent together
+        needs_update = spa->get_publish_limiter().check_changed(limit_slot, needs_update, millis());
     }
-    
+
     if(needs_update) {
         this->publish_state();
-        this->last_update_time = millis();
     }
 }
 
+void BalboaSpaThermostat::refresh() {
+    // Keeps Home Assistant in sync; the fields already hold any change a publish limit held back
+    if (!spa->is_communicating()) {
+        return;
+    }
+    this->publish_state();
+    spa->get_publish_limiter().published(limit_slot, 0, millis());
+}
+
 }
 }
\ No newline at end of file
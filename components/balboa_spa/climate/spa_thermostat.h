@@ -11,11 +11,14 @@ class BalboaSpaThermostat : public climate::Climate, public Component {
  public:
   BalboaSpaThermostat() {
     spa = nullptr;
-    last_update_time = 0;
   };
 
   void update(SpaState* spaState);
+  // Re-publishes the current state, called by the parent's refresh scheduler
+  void refresh();
   void set_parent(BalboaSpa *parent);
+  // Call after set_parent(); the parent applies the limit
+  void set_publish_limit(uint32_t min_interval_ms);
 
  protected:
   void control(const climate::ClimateCall &call) override;
@@ -23,7 +26,7 @@ class BalboaSpaThermostat : public climate::Climate, public Component {
 
  private:
   BalboaSpa *spa;
-  uint32_t last_update_time;
+  PublishLimiter::Slot limit_slot = PublishLimiter::NO_SLOT;
 };
 
 }  // namespace balboa_spa
@@ -0,0 +1,53 @@
+#include "clock_sync.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+static const int32_t SECONDS_PER_DAY = 24 * 60 * 60;
+// Minimum span for a drift estimate; at one second of resolution this is about 24 s/day
+static const uint32_t MIN_DRIFT_SPAN_S = 60 * 60;
+
+void SpaClockSync::observe_tick(uint16_t spa_minute_of_day, uint32_t real_second_of_day, uint32_t epoch) {
+    int32_t error = static_cast<int32_t>(spa_minute_of_day) * 60 - static_cast<int32_t>(real_second_of_day);
+    // Closest way around midnight
+    if (error > SECONDS_PER_DAY / 2) {
+        error -= SECONDS_PER_DAY;
+    } else if (error < -SECONDS_PER_DAY / 2) {
+        error += SECONDS_PER_DAY;
+    }
+    error_ = error;
+    has_error_ = true;
+
+    if (!has_anchor_) {
+        anchor_error_ = error;
+        anchor_epoch_ = epoch;
+        has_anchor_ = true;
+        return;
+    }
+    uint32_t span = epoch - anchor_epoch_;
+    if (span >= MIN_DRIFT_SPAN_S) {
+        drift_ = static_cast<float>(error - anchor_error_) * SECONDS_PER_DAY / span;
+        has_drift_ = true;
+    }
+}
+
+bool SpaClockSync::sync_due(uint32_t now) const {
+    if (!has_error_ || static_cast<uint32_t>(std::abs(error_)) <= threshold_) {
+        return false;
+    }
+    return !has_synced_ || now - last_sync_ >= min_interval_;
+}
+
+void SpaClockSync::synced(uint32_t now) {
+    has_synced_ = true;
+    last_sync_ = now;
+}
+
+void SpaClockSync::clock_set() {
+    // The error jumps with the new time; wait for the next tick and restart drift from there
+    has_error_ = false;
+    has_anchor_ = false;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
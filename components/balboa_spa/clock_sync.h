@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Measures how far the spa clock is off from real time and how fast it drifts.
+ *
+ * The spa only reports hours and minutes, so the error is sampled at the
+ * moment the spa minute ticks over, when its seconds are zero. Drift is the
+ * change in error over the time since the last anchor (boot or the last
+ * confirmed clock write).
+ * A sync is due when the error exceeds the threshold and the previous sync
+ * was long enough ago; it should be sent at the start of a real minute so the
+ * spa's seconds line up.
+ */
+class SpaClockSync {
+  public:
+    void set_threshold(uint32_t seconds) { threshold_ = seconds; }
+    void set_min_interval(uint32_t interval_ms) { min_interval_ = interval_ms; }
+
+    // Called when the spa minute changes, with real local time of day and epoch
+    void observe_tick(uint16_t spa_minute_of_day, uint32_t real_second_of_day, uint32_t epoch);
+    bool sync_due(uint32_t now) const;
+    // Called when an automatic sync was requested; only rate limits the next one
+    void synced(uint32_t now);
+    // Called when the spa confirmed a new time, from a sync or a manual write
+    void clock_set();
+
+    // Spa minus real time in seconds; NAN until a tick was seen
+    float error_seconds() const { return has_error_ ? error_ : NAN; }
+    // Seconds gained per day; NAN until enough time passed since the last anchor
+    float drift_seconds_per_day() const { return has_drift_ ? drift_ : NAN; }
+
+  private:
+    uint32_t threshold_ = 30;
+    uint32_t min_interval_ = 60 * 60 * 1000;
+
+    bool has_error_ = false;
+    int32_t error_ = 0;
+
+    bool has_anchor_ = false;
+    int32_t anchor_error_ = 0;
+    uint32_t anchor_epoch_ = 0;
+
+    bool has_drift_ = false;
+    float drift_ = 0;
+
+    bool has_synced_ = false;
+    uint32_t last_sync_ = 0;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
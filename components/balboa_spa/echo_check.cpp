@@ -0,0 +1,85 @@
+#include "echo_check.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+void EchoCheck::sent(const uint8_t *frame, size_t frame_size, bool retransmittable, uint32_t now) {
+    if (!enabled_) {
+        return;
+    }
+    if (retransmit_size_ != 0) {
+        // Only happens for frames sent outside a clear-to-send slot
+        retransmit_size_ = 0;
+        abandoned_++;
+    }
+    for (size_t i = 0; i < frame_size; i++) {
+        frame_[i] = frame[i];
+    }
+    frame_size_ = frame_size;
+    retransmittable_ = retransmittable;
+    attempts_ = 0;
+    start(now);
+}
+
+void EchoCheck::resent(uint32_t now) {
+    retransmits_++;
+    retransmit_size_ = 0;
+    start(now);
+}
+
+void EchoCheck::start(uint32_t now) {
+    attempts_++;
+    matched_ = 0;
+    discard_ = 0;
+    awaiting_ = true;
+    sent_at_ = now;
+}
+
+EchoCheck::Result EchoCheck::on_byte(uint8_t byte) {
+    if (discard_ > 0) {
+        discard_--;
+        return ECHO;
+    }
+    if (!awaiting_) {
+        return NOT_ECHO;
+    }
+    if (byte != frame_[matched_]) {
+        // The byte itself is part of the garbled window; drop the rest of it too
+        discard_ = frame_size_ - matched_ - 1;
+        silent_sends_ = 0;
+        collided();
+        return COLLISION;
+    }
+    silent_sends_ = 0;
+    if (++matched_ == frame_size_) {
+        awaiting_ = false;
+    }
+    return ECHO;
+}
+
+bool EchoCheck::expired(uint32_t now) {
+    if (!awaiting_ || now - sent_at_ < ECHO_TIMEOUT_MS) {
+        return false;
+    }
+    if (matched_ == 0 && silent_sends_ < 0xFF) {
+        silent_sends_++;
+    }
+    collided();
+    return true;
+}
+
+void EchoCheck::collided() {
+    awaiting_ = false;
+    collisions_++;
+    if (!retransmittable_) {
+        return;
+    }
+    if (attempts_ > max_retries_) {
+        abandoned_++;
+        return;
+    }
+    retransmit_size_ = frame_size_;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "balboa_protocol.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Verifies the echo of our own transmissions on half-duplex transceivers.
+ *
+ * After a frame is sent, received bytes are matched against it and consumed
+ * instead of reaching the frame parser. A mismatch, or no complete echo
+ * within the timeout, means another node talked over us: the rest of the
+ * echo window is discarded and the frame is kept for retransmission at the
+ * next clear-to-send, up to max_retries times.
+ */
+class EchoCheck {
+  public:
+    enum Result : uint8_t {
+        NOT_ECHO,   // no transmission outstanding, feed the byte to the parser
+        ECHO,       // byte was part of our echo
+        COLLISION,  // byte did not match; our frame was corrupted on the bus
+    };
+
+    static const uint32_t ECHO_TIMEOUT_MS = 20;
+
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+    void set_max_retries(uint8_t retries) { max_retries_ = retries; }
+
+    // Called right after a new frame was written; retransmittable frames are kept for a retry
+    void sent(const uint8_t *frame, size_t frame_size, bool retransmittable, uint32_t now);
+    // Called right after retransmit_frame() was written again
+    void resent(uint32_t now);
+    Result on_byte(uint8_t byte);
+    // Called periodically; a missing echo is treated as a collision
+    bool expired(uint32_t now);
+
+    // A collided frame waiting for the next clear-to-send
+    bool retransmit_due() const { return retransmit_size_ != 0; }
+    protocol::ByteSpan retransmit_frame() const { return {frame_, retransmit_size_}; }
+
+    uint32_t collisions() const { return collisions_; }
+    uint32_t retransmits() const { return retransmits_; }
+    uint32_t abandoned() const { return abandoned_; }
+    // Consecutive sends without any echo byte; a non-echoing transceiver shows up here
+    uint8_t silent_sends() const { return silent_sends_; }
+
+  private:
+    void start(uint32_t now);
+    void collided();
+
+    uint8_t frame_[protocol::MAX_FRAME_SIZE];
+    size_t frame_size_ = 0;
+    size_t matched_ = 0;
+    size_t discard_ = 0;  // bytes of a collided echo still to drop
+    size_t retransmit_size_ = 0;
+    bool awaiting_ = false;
+    bool retransmittable_ = false;
+    bool enabled_ = false;
+    uint8_t attempts_ = 0;
+    uint8_t max_retries_ = 3;
+    uint8_t silent_sends_ = 0;
+    uint32_t sent_at_ = 0;
+
+    uint32_t collisions_ = 0;
+    uint32_t retransmits_ = 0;
+    uint32_t abandoned_ = 0;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,71 @@
+#include "energy_meter.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+static const double MJ_PER_KWH = 3600000000.0;
+static const double MS_PER_HOUR = 3600000.0;
+
+void SpaEnergyMeter::set_power(SpaLoad load, uint8_t speed, float watts) {
+    if (load >= LOAD_COUNT || speed < 1 || speed > 2) {
+        return;
+    }
+    watts_[load][speed - 1] = static_cast<uint16_t>(watts);
+    enabled_ = true;
+}
+
+uint8_t SpaEnergyMeter::speed_of(SpaLoad load, const SpaState &spaState) const {
+    switch (load) {
+        case LOAD_HEATER: return spaState.heat_state == 1;
+        case LOAD_PUMP1: return spaState.pump1;
+        case LOAD_PUMP2: return spaState.pump2;
+        case LOAD_PUMP3: return spaState.pump3;
+        case LOAD_BLOWER: return spaState.blower;
+        case LOAD_CIRCULATION: return spaState.circulation;
+        case LOAD_PUMP4: return spaState.pump4;
+        case LOAD_PUMP5: return spaState.pump5;
+        case LOAD_PUMP6: return spaState.pump6;
+        default: return 0;
+    }
+}
+
+void SpaEnergyMeter::integrate(uint32_t elapsed_ms, const SpaState &spaState) {
+    for (uint8_t load = 0; load < LOAD_COUNT; load++) {
+        uint8_t speed = speed_of(static_cast<SpaLoad>(load), spaState);
+        if (speed == 0) {
+            continue;
+        }
+        uint16_t watts = watts_[load][speed > 1 ? 1 : 0];
+        if (watts == 0 && speed > 1) {
+            watts = watts_[load][0];  // two-speed pump with only one power configured
+        }
+        uint64_t mj = static_cast<uint64_t>(watts) * elapsed_ms;
+        counters_.energy_mj[load] += mj;
+        counters_.today_mj += mj;
+        counters_.runtime_ms[load] += elapsed_ms;
+    }
+}
+
+// A backward jump at least this large is the clock passing midnight; smaller ones are clock corrections
+static const uint8_t DAY_ROLLOVER_MIN_HOURS_BACK = 12;
+
+void SpaEnergyMeter::observe_clock(uint8_t hour) {
+    if (last_hour_ != 0xFF && hour < last_hour_ && last_hour_ - hour >= DAY_ROLLOVER_MIN_HOURS_BACK) {
+        counters_.today_mj = 0;
+    }
+    last_hour_ = hour;
+}
+
+void SpaEnergyMeter::take_snapshot() {
+    uint64_t total_mj = 0;
+    for (uint8_t load = 0; load < LOAD_COUNT; load++) {
+        total_mj += counters_.energy_mj[load];
+        snapshot_kwh_[load] = counters_.energy_mj[load] / MJ_PER_KWH;
+        snapshot_hours_[load] = counters_.runtime_ms[load] / MS_PER_HOUR;
+    }
+    snapshot_total_kwh_ = total_mj / MJ_PER_KWH;
+    snapshot_today_kwh_ = counters_.today_mj / MJ_PER_KWH;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+
+#include "spa_state.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+enum SpaLoad : uint8_t {
+    LOAD_HEATER = 0,
+    LOAD_PUMP1,
+    LOAD_PUMP2,
+    LOAD_PUMP3,
+    LOAD_BLOWER,
+    LOAD_CIRCULATION,
+    LOAD_PUMP4,
+    LOAD_PUMP5,
+    LOAD_PUMP6,
+    LOAD_COUNT
+};
+
+// Energy counters kept in flash across reboots and OTA updates
+struct SpaEnergyCounters {
+    uint64_t energy_mj[LOAD_COUNT];   // millijoules (W * ms) per load
+    uint64_t runtime_ms[LOAD_COUNT];  // time each load was on
+    uint64_t today_mj;                // all loads since the spa clock last passed midnight
+};
+
+/**
+ * Integrates nameplate power over the on-time of each load decoded from the
+ * status frames. Counting in W*ms keeps the totals exact integers; the
+ * float values used by the sensors are only refreshed by take_snapshot(),
+ * so publishing runs at its own cadence.
+ */
+class SpaEnergyMeter {
+  public:
+    // speed is 1 for low (or single speed), 2 for high
+    void set_power(SpaLoad load, uint8_t speed, float watts);
+    bool enabled() const { return enabled_; }
+
+    void integrate(uint32_t elapsed_ms, const SpaState &spaState);
+    // Resets the daily total when the spa clock wraps past midnight, e.g. 23 -> 0, but not when
+    // a sync or set_hour() moves it back by a few hours
+    void observe_clock(uint8_t hour);
+
+    SpaEnergyCounters &counters() { return counters_; }
+    void take_snapshot();
+
+    // kWh / hours as of the last snapshot; NAN when energy metering is not configured
+    float total_kwh() const { return enabled_ ? snapshot_total_kwh_ : NAN; }
+    float today_kwh() const { return enabled_ ? snapshot_today_kwh_ : NAN; }
+    float energy_kwh(SpaLoad load) const { return enabled_ ? snapshot_kwh_[load] : NAN; }
+    float runtime_hours(SpaLoad load) const { return enabled_ ? snapshot_hours_[load] : NAN; }
+
+  private:
+    uint8_t speed_of(SpaLoad load, const SpaState &spaState) const;
+
+    uint16_t watts_[LOAD_COUNT][2] = {};
+    bool enabled_ = false;
+    uint8_t last_hour_ = 0xFF;
+    SpaEnergyCounters counters_ = {};
+
+    float snapshot_total_kwh_ = 0;
+    float snapshot_today_kwh_ = 0;
+    float snapshot_kwh_[LOAD_COUNT] = {};
+    float snapshot_hours_[LOAD_COUNT] = {};
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
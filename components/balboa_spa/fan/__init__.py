@@ -0,0 +1,41 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import fan
+
+from .. import (
+    balboa_spa_ns,
+    BalboaSpa,
+    CONF_SPA_ID
+)
+
+DEPENDENCIES = ["balboa_spa"]
+AUTO_LOAD = ["fan"]
+
+SpaPumpFan = balboa_spa_ns.class_("SpaPumpFan", fan.Fan)
+
+# Key -> pump number
+PUMP_TYPES = {
+    "pump1": 1,
+    "pump2": 2,
+    "pump3": 3,
+    "pump4": 4,
+    "pump5": 5,
+    "pump6": 6,
+}
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_SPA_ID): cv.use_id(BalboaSpa),
+    }).extend({
+        cv.Optional(pump_type): fan.fan_schema(SpaPumpFan, icon="mdi:pump")
+        for pump_type in PUMP_TYPES
+    })
+
+async def to_code(config):
+    parent = await cg.get_variable(config[CONF_SPA_ID])
+
+    for pump_type, pump in PUMP_TYPES.items():
+        if conf := config.get(pump_type):
+            fan_var = await fan.new_fan(conf)
+            cg.add(fan_var.set_pump(pump))
+            cg.add(fan_var.set_parent(parent))
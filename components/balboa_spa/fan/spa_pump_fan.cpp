@@ -0,0 +1,76 @@
+#include "esphome/core/log.h"
+#include "spa_pump_fan.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+static const char *TAG = "BalboaSpa.fan";
+
+void SpaPumpFan::set_parent(BalboaSpa *parent) {
+    spa = parent;
+    parent->register_listener([this](SpaState* spaState){ this->update(spaState); }, sizeof(*this), equipment());
+}
+
+uint8_t SpaPumpFan::speed_count() const {
+    // Until the configuration response arrives assume two speeds, so nothing is hidden
+    if (spa == nullptr || !spa->is_config_received()) {
+        return 2;
+    }
+    SpaConfig config = spa->get_current_config();
+    const uint8_t speeds[] = {0, config.pump1, config.pump2, config.pump3, config.pump4, config.pump5, config.pump6};
+    return speeds[pump] == 1 ? 1 : 2;
+}
+
+uint8_t SpaPumpFan::level_of(const SpaState &spaState) const {
+    switch (pump) {
+        case 1: return spaState.pump1;
+        case 2: return spaState.pump2;
+        case 3: return spaState.pump3;
+        case 4: return spaState.pump4;
+        case 5: return spaState.pump5;
+        case 6: return spaState.pump6;
+        default: return 0;
+    }
+}
+
+fan::FanTraits SpaPumpFan::get_traits() {
+    return fan::FanTraits(false, true, false, speed_count());
+}
+
+void SpaPumpFan::update(SpaState* spaState) {
+    uint8_t level = level_of(*spaState);
+    bool on = level != 0;
+    // One-speed pumps report "on" as the high level
+    int new_speed = on ? (speed_count() == 1 ? 1 : level) : this->speed;
+
+    if (this->state != on || this->speed != new_speed) {
+        this->state = on;
+        this->speed = new_speed;
+        this->publish_state();
+    }
+}
+
+void SpaPumpFan::control(const fan::FanCall &call) {
+    if (!spa->is_communicating()) {
+        ESP_LOGW(TAG, "Cannot control pump %d - spa not communicating", pump);
+        return;
+    }
+    if (!spa->has_equipment(equipment())) {
+        ESP_LOGW(TAG, "Cannot control pump %d - not present on this spa", pump);
+        return;
+    }
+
+    uint8_t level = 0;
+    if (call.get_state().value_or(this->state)) {
+        if (speed_count() == 1) {
+            level = ToggleReconciler::LEVEL_ON;
+        } else {
+            level = call.get_speed().value_or(this->speed) >= 2 ? 2 : 1;
+        }
+    }
+    // The state is published once the status frame shows the new speed
+    spa->set_item_level(TOGGLE_ITEM_PUMP1 + pump - 1, level);
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
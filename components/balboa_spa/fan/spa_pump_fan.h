@@ -0,0 +1,33 @@
+#pragma once
+
+#include "esphome/components/fan/fan.h"
+#include "../balboaspa.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+// A jet pump as a fan: speed 1 is low and 2 is high on two-speed pumps,
+// one-speed pumps only have speed 1. Speed changes go through the toggle
+// reconciler, which sends as many toggles as the step needs.
+class SpaPumpFan : public fan::Fan {
+ public:
+  SpaPumpFan() {};
+  void update(SpaState* spaState);
+  void set_parent(BalboaSpa *parent);
+  void set_pump(uint8_t pump) { this->pump = pump; }
+  fan::FanTraits get_traits() override;
+
+ protected:
+  void control(const fan::FanCall &call) override;
+
+ private:
+  uint8_t speed_count() const;
+  uint8_t level_of(const SpaState &spaState) const;
+  uint16_t equipment() const { return EQUIPMENT_PUMP1 << (pump - 1); }
+
+  BalboaSpa *spa = nullptr;
+  uint8_t pump = 1;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
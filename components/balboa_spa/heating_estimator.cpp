@@ -0,0 +1,54 @@
+#include "heating_estimator.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+void HeatingRateEstimator::update(uint32_t now, float temperature, bool heating) {
+    if (std::isnan(temperature)) {
+        return;
+    }
+
+    // Heater switched: the time since the last step does not belong to either mode
+    if (std::isnan(last_temp_) || heating != last_heating_) {
+        heat_.direction = 0;
+        cool_.direction = 0;
+        last_heating_ = heating;
+        last_temp_ = temperature;
+        return;
+    }
+
+    if (temperature == last_temp_) {
+        return;
+    }
+
+    Track &track = heating ? heat_ : cool_;
+    int8_t direction = temperature > last_temp_ ? 1 : -1;
+    if (track.direction == direction) {
+        uint32_t elapsed_ms = now - track.anchor_time;
+        if (elapsed_ms > 0) {
+            float sample = (temperature - track.anchor_temp) * 3600000.0f / elapsed_ms;
+            track.rate = track.has_rate ? track.rate + SMOOTHING * (sample - track.rate) : sample;
+            track.has_rate = true;
+        }
+    }
+    track.anchor_temp = temperature;
+    track.anchor_time = now;
+    track.direction = direction;
+    last_temp_ = temperature;
+}
+
+float HeatingRateEstimator::minutes_to_target(float current, float target) const {
+    if (std::isnan(current) || std::isnan(target)) {
+        return NAN;
+    }
+    if (current >= target) {
+        return 0;
+    }
+    if (!heat_.has_rate || heat_.rate <= 0) {
+        return NAN;
+    }
+    return (target - current) / heat_.rate * 60.0f;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Estimates how fast the water heats and cools, in degrees per hour.
+ *
+ * The spa reports temperature in 0.5 C / 1 F steps, so instead of
+ * differentiating every frame the estimator measures the time between two
+ * consecutive steps in the same direction. A step back the other way is
+ * treated as dither around a boundary and only re-anchors the measurement.
+ * Separate rates are kept for heater on and heater off; each new
+ * measurement is folded into an exponential moving average.
+ *
+ * O(1) per status frame and no allocation.
+ */
+class HeatingRateEstimator {
+  public:
+    void update(uint32_t now, float temperature, bool heating);
+
+    // Degrees per hour in the temperature unit fed to update(); NAN until measured
+    float heating_rate() const { return heat_.has_rate ? heat_.rate : NAN; }
+    float cooling_rate() const { return cool_.has_rate ? cool_.rate : NAN; }
+
+    // Minutes until current reaches target at the heating rate; 0 when already there, NAN when unknown
+    float minutes_to_target(float current, float target) const;
+
+  private:
+    // Weight of a new measurement in the moving average
+    static constexpr float SMOOTHING = 0.3f;
+
+    struct Track {
+        float anchor_temp = NAN;
+        uint32_t anchor_time = 0;
+        int8_t direction = 0;  // direction of the step that set the anchor, 0 = none yet
+        bool has_rate = false;
+        float rate = 0;
+    };
+
+    Track heat_;
+    Track cool_;
+    float last_temp_ = NAN;
+    bool last_heating_ = false;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,78 @@
+#include "publish_limiter.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace balboa_spa {
+
+PublishLimiter::Slot PublishLimiter::add(uint32_t min_interval_ms, float deadband) {
+    if (slots_.size() >= NO_SLOT) {
+        return NO_SLOT;
+    }
+    slots_.push_back({min_interval_ms, deadband, NAN, NAN, 0, false});
+    return slots_.size() - 1;
+}
+
+bool PublishLimiter::due(const Limit &limit, uint32_t now) const {
+    return std::isnan(limit.published) || now - limit.last_publish >= limit.min_interval_ms;
+}
+
+bool PublishLimiter::check_value(Slot slot, float value, uint32_t now) {
+    Limit &limit = slots_[slot];
+    bool changed = value != limit.last_seen;
+    limit.last_seen = value;
+
+    bool outside = std::isnan(limit.published) ||
+                   (value != limit.published && std::fabs(value - limit.published) >= limit.deadband);
+    if (!outside) {
+        if (limit.pending) {
+            // The held value never got out
+            limit.pending = false;
+            suppressed_++;
+        } else if (changed && value != limit.published) {
+            suppressed_++;
+        }
+        return false;
+    }
+
+    if (due(limit, now)) {
+        published(slot, value, now);
+        return true;
+    }
+    if (limit.pending && changed) {
+        suppressed_++;
+    }
+    limit.pending = true;
+    return false;
+}
+
+bool PublishLimiter::check_changed(Slot slot, bool changed, uint32_t now) {
+    Limit &limit = slots_[slot];
+    if (!changed && !limit.pending) {
+        return false;
+    }
+    if (due(limit, now)) {
+        // The fields live in the entity; only the time matters here
+        published(slot, 0, now);
+        return true;
+    }
+    if (limit.pending && changed) {
+        suppressed_++;
+    }
+    limit.pending = true;
+    return false;
+}
+
+void PublishLimiter::published(Slot slot, float value, uint32_t now) {
+    if (slot == NO_SLOT) {
+        return;
+    }
+    Limit &limit = slots_[slot];
+    limit.published = value;
+    limit.last_seen = value;
+    limit.last_publish = now;
+    limit.pending = false;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Minimum publish intervals and deadbands for entities, kept in one place.
+ *
+ * Each limited entity registers a slot and asks the limiter on every status
+ * frame whether its current value should be published. A change beyond the
+ * deadband is published at once if the entity's interval has elapsed since
+ * its last publish; otherwise it is held, and whatever value is current when
+ * the interval elapses is published instead. Entities without a slot are not
+ * limited.
+ *
+ * suppressed() counts values that never reached Home Assistant: changes
+ * within the deadband, and held values that were replaced by a newer one or
+ * fell back inside the deadband before they could be published.
+ */
+class PublishLimiter {
+  public:
+    using Slot = uint8_t;
+    static const Slot NO_SLOT = 0xFF;
+
+    // Returns NO_SLOT once all slots are taken, leaving the entity unlimited
+    Slot add(uint32_t min_interval_ms, float deadband);
+
+    // Called with the entity's current value; true when it should be published now
+    bool check_value(Slot slot, float value, uint32_t now);
+    // For entities with several fields: true when a change, possibly an earlier held one, should be published now
+    bool check_changed(Slot slot, bool changed, uint32_t now);
+    // Records a publish made outside the checks, such as a periodic refresh
+    void published(Slot slot, float value, uint32_t now);
+
+    uint32_t suppressed() const { return suppressed_; }
+    size_t size() const { return slots_.size(); }
+    size_t heap_bytes() const { return slots_.capacity() * sizeof(Limit); }
+
+  private:
+    struct Limit {
+        uint32_t min_interval_ms;
+        float deadband;
+        float published;  // NAN until the first publish
+        float last_seen;
+        uint32_t last_publish;
+        bool pending;
+    };
+
+    bool due(const Limit &limit, uint32_t now) const;
+
+    std::vector<Limit> slots_;
+    uint32_t suppressed_ = 0;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
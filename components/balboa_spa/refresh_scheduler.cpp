@@ -0,0 +1,57 @@
+#include "refresh_scheduler.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+void RefreshScheduler::add(Callback callback) {
+    entries_.push_back({std::move(callback), 0});
+    // Entities added after the first run spread everything out again
+    started_ = false;
+}
+
+void RefreshScheduler::start(uint32_t now) {
+    size_t count = entries_.size();
+    for (size_t i = 0; i < count; i++) {
+        entries_[i].next_due = now + static_cast<uint32_t>(static_cast<uint64_t>(interval_ms_) * (i + 1) / count);
+    }
+    started_ = true;
+}
+
+void RefreshScheduler::run(uint32_t now) {
+    if (interval_ms_ == 0 || entries_.empty()) {
+        return;
+    }
+    if (!started_) {
+        start(now);
+        return;
+    }
+
+    size_t count = entries_.size();
+    uint8_t ran = 0;
+    // The cursor only moves after the scan, so every entry is visited exactly once
+    size_t start = cursor_;
+    size_t next_cursor = cursor_;
+    for (size_t scanned = 0; scanned < count; scanned++) {
+        size_t index = (start + scanned) % count;
+        Entry &entry = entries_[index];
+        if (!reached(now, entry.next_due)) {
+            continue;
+        }
+        if (ran == max_per_poll_) {
+            deferred_++;
+            continue;
+        }
+        entry.callback();
+        ran++;
+        next_cursor = (index + 1) % count;
+        entry.next_due += interval_ms_;
+        if (reached(now, entry.next_due)) {
+            // Far behind, e.g. after a long blocking call; restart the phase from now
+            entry.next_due = now + interval_ms_;
+        }
+    }
+    cursor_ = next_cursor;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Periodic forced re-publishing of entities, so Home Assistant stays in sync
+ * even when nothing changes.
+ *
+ * Every entity is refreshed once per interval, but at its own phase: on the
+ * first run the entities are spread evenly over the interval, and each keeps
+ * its slot from then on. At most max_per_poll refreshes run per call; any
+ * others that are due wait for the next poll, taken round robin so none is
+ * starved. Deadlines are compared as signed differences, so the millis()
+ * wrap after ~49 days does not matter.
+ */
+class RefreshScheduler {
+  public:
+    using Callback = std::function<void()>;
+
+    void set_interval(uint32_t interval_ms) { interval_ms_ = interval_ms; }
+    void set_max_per_poll(uint8_t max_per_poll) { max_per_poll_ = max_per_poll; }
+    uint32_t interval() const { return interval_ms_; }
+
+    void add(Callback callback);
+    // Called every poll; runs the refreshes that are due, up to max_per_poll
+    void run(uint32_t now);
+
+    size_t size() const { return entries_.size(); }
+    size_t heap_bytes() const { return entries_.capacity() * sizeof(Entry); }
+    // Times a due refresh had to wait a poll because of max_per_poll
+    uint32_t deferred() const { return deferred_; }
+
+  private:
+    struct Entry {
+        Callback callback;
+        uint32_t next_due;
+    };
+
+    static bool reached(uint32_t now, uint32_t deadline) { return static_cast<int32_t>(now - deadline) >= 0; }
+    void start(uint32_t now);
+
+    std::vector<Entry> entries_;
+    uint32_t interval_ms_ = 300000;
+    uint8_t max_per_poll_ = 2;
+    bool started_ = false;
+    size_t cursor_ = 0;  // where the next round robin scan begins
+    uint32_t deferred_ = 0;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -1,11 +1,25 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import sensor
+from esphome.const import (
+    DEVICE_CLASS_DURATION,
+    DEVICE_CLASS_ENERGY,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_HOUR,
+    UNIT_KILOWATT_HOURS,
+    UNIT_MICROSECOND,
+    UNIT_MILLISECOND,
+    UNIT_SECOND,
+)
 
 from .. import (
     balboa_spa_ns,
     BalboaSpa,
-    CONF_SPA_ID
+    CONF_DEADBAND,
+    CONF_MIN_PUBLISH_INTERVAL,
+    CONF_SPA_ID,
+    PUBLISH_LIMIT_SCHEMA,
 )
 
 DEPENDENCIES = ["balboa_spa"]
@@ -34,91 +48,531 @@ CONF_FILTER1_CYCLES_COMPLETED = "filter1_cycles_completed"
 CONF_FILTER2_CYCLES_COMPLETED = "filter2_cycles_completed"
 CONF_FILTER1_CURRENT_RUNTIME_MINUTES = "filter1_current_runtime_minutes"
 CONF_FILTER2_CURRENT_RUNTIME_MINUTES = "filter2_current_runtime_minutes"
+CONF_FILTER_COUNTER_WRITES_TODAY = "filter_counter_writes_today"
+CONF_HEATING_RATE = "heating_rate"
+CONF_COOLING_RATE = "cooling_rate"
+CONF_TIME_TO_TARGET = "time_to_target"
+CONF_ENERGY_TOTAL = "energy_total"
+CONF_ENERGY_TODAY = "energy_today"
+CONF_HEATER_ENERGY = "heater_energy"
+CONF_HEATER_RUNTIME = "heater_runtime"
+CONF_PUMP1_ENERGY = "pump1_energy"
+CONF_PUMP1_RUNTIME = "pump1_runtime"
+CONF_PUMP2_ENERGY = "pump2_energy"
+CONF_PUMP2_RUNTIME = "pump2_runtime"
+CONF_PUMP3_ENERGY = "pump3_energy"
+CONF_PUMP3_RUNTIME = "pump3_runtime"
+CONF_BLOWER_ENERGY = "blower_energy"
+CONF_BLOWER_RUNTIME = "blower_runtime"
+CONF_CIRCULATION_ENERGY = "circulation_energy"
+CONF_CIRCULATION_RUNTIME = "circulation_runtime"
+CONF_TOGGLE_CONVERGENCE_TIME = "toggle_convergence_time"
+CONF_TOGGLE_RETRIES = "toggle_retries"
+CONF_TOGGLE_FAILURES = "toggle_failures"
+CONF_WRITES_CONFIRMED = "writes_confirmed"
+CONF_WRITES_RETRIED = "writes_retried"
+CONF_WRITES_ABANDONED = "writes_abandoned"
+CONF_CLOCK_ERROR = "clock_error"
+CONF_CLOCK_DRIFT = "clock_drift"
+CONF_BUS_BYTES_LOST = "bus_bytes_lost"
+CONF_BUS_RESYNC_TIME = "bus_resync_time"
+CONF_BUS_COLLISIONS = "bus_collisions"
+CONF_BUS_RETRANSMITS = "bus_retransmits"
+CONF_BUS_TURNAROUND = "bus_turnaround"
+CONF_BUS_STATUS_PERIOD = "bus_status_period"
+CONF_BUS_CTS_PERIOD = "bus_cts_period"
+CONF_BUS_REPLY_LATENCY = "bus_reply_latency"
+CONF_BUS_CRC_ERRORS = "bus_crc_errors"
+CONF_BUS_OVERSIZED_FRAMES = "bus_oversized_frames"
+CONF_BUS_TRUNCATED_FRAMES = "bus_truncated_frames"
+CONF_BUS_SHORT_FRAMES = "bus_short_frames"
+CONF_BUS_LONG_FRAMES = "bus_long_frames"
+CONF_PUBLISHES_SUPPRESSED = "publishes_suppressed"
+CONF_BOOT_TO_FIRST_STATE = "boot_to_first_state"
+CONF_BOOT_TO_POPULATED = "boot_to_populated"
+CONF_BOOT_TO_READY = "boot_to_ready"
+CONF_CONFIGURATION_REQUEST_RETRIES = "configuration_request_retries"
+CONF_FILTER_CYCLES_REQUEST_RETRIES = "filter_cycles_request_retries"
+CONF_INFORMATION_REQUEST_RETRIES = "information_request_retries"
+CONF_PREFERENCES_REQUEST_RETRIES = "preferences_request_retries"
+CONF_FAULT_LOG_REQUEST_RETRIES = "fault_log_request_retries"
+CONF_PUMP4_ENERGY = "pump4_energy"
+CONF_PUMP4_RUNTIME = "pump4_runtime"
+CONF_PUMP5_ENERGY = "pump5_energy"
+CONF_PUMP5_RUNTIME = "pump5_runtime"
+CONF_PUMP6_ENERGY = "pump6_energy"
+CONF_PUMP6_RUNTIME = "pump6_runtime"
+
+# One entry per row of BALBOA_SPA_SENSOR_TYPES in sensors.h; the key upper-cased is the row name
+SENSOR_TYPES = {
+    CONF_BLOWER: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_HIGHRANGE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_CIRCULATION: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_RESTMODE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_HEATSTATE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_CLOCK_HOUR: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_CLOCK_MINUTE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER1_START_HOUR: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER1_START_MINUTE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER1_DURATION_HOUR: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER1_DURATION_MINUTE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER2_START_HOUR: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER2_START_MINUTE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER2_DURATION_HOUR: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER2_DURATION_MINUTE: sensor.sensor_schema(
+        SpaSensor,
+    ),
+    CONF_FILTER1_RUNTIME_HOURS: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="h",
+        accuracy_decimals=2,
+        icon="mdi:clock-outline",
+    ),
+    CONF_FILTER2_RUNTIME_HOURS: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="h",
+        accuracy_decimals=2,
+        icon="mdi:clock-outline",
+    ),
+    CONF_FILTER1_CYCLES_COMPLETED: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:counter",
+    ),
+    CONF_FILTER2_CYCLES_COMPLETED: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:counter",
+    ),
+    CONF_FILTER1_CURRENT_RUNTIME_MINUTES: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="min",
+        icon="mdi:timer",
+    ),
+    CONF_FILTER2_CURRENT_RUNTIME_MINUTES: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="min",
+        icon="mdi:timer",
+    ),
+    CONF_FILTER_COUNTER_WRITES_TODAY: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:content-save",
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_HEATING_RATE: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="°/h",
+        icon="mdi:thermometer-chevron-up",
+        accuracy_decimals=1,
+    ),
+    CONF_COOLING_RATE: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="°/h",
+        icon="mdi:thermometer-chevron-down",
+        accuracy_decimals=1,
+    ),
+    CONF_TIME_TO_TARGET: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="min",
+        icon="mdi:timer-sand",
+        accuracy_decimals=0,
+    ),
+    CONF_ENERGY_TOTAL: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_ENERGY_TODAY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_HEATER_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_HEATER_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUMP1_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_PUMP1_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUMP2_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_PUMP2_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUMP3_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_PUMP3_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BLOWER_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_BLOWER_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_CIRCULATION_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_CIRCULATION_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_TOGGLE_CONVERGENCE_TIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_SECOND,
+        accuracy_decimals=1,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_TOGGLE_RETRIES: sensor.sensor_schema(
+        SpaSensor,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_TOGGLE_FAILURES: sensor.sensor_schema(
+        SpaSensor,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_WRITES_CONFIRMED: sensor.sensor_schema(
+        SpaSensor,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_WRITES_RETRIED: sensor.sensor_schema(
+        SpaSensor,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_WRITES_ABANDONED: sensor.sensor_schema(
+        SpaSensor,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_CLOCK_ERROR: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_SECOND,
+        icon="mdi:clock-alert-outline",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_CLOCK_DRIFT: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement="s/d",
+        icon="mdi:clock-fast",
+        accuracy_decimals=1,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_BYTES_LOST: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:transmission-tower-off",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_RESYNC_TIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:sync-alert",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_COLLISIONS: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:car-brake-alert",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_RETRANSMITS: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:replay",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_TURNAROUND: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MICROSECOND,
+        icon="mdi:swap-horizontal",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_STATUS_PERIOD: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:metronome",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_CTS_PERIOD: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:metronome-tick",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_REPLY_LATENCY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MICROSECOND,
+        icon="mdi:timer-sand",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_CRC_ERRORS: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:alert-circle-outline",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_OVERSIZED_FRAMES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:alert-circle-outline",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_TRUNCATED_FRAMES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:alert-circle-outline",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_SHORT_FRAMES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:alert-circle-outline",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BUS_LONG_FRAMES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:alert-circle-outline",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUBLISHES_SUPPRESSED: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:speedometer-slow",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BOOT_TO_FIRST_STATE: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:timer-play-outline",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BOOT_TO_POPULATED: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:timer-check-outline",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_BOOT_TO_READY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:timer-star-outline",
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_CONFIGURATION_REQUEST_RETRIES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:repeat",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_FILTER_CYCLES_REQUEST_RETRIES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:repeat",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_INFORMATION_REQUEST_RETRIES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:repeat",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PREFERENCES_REQUEST_RETRIES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:repeat",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_FAULT_LOG_REQUEST_RETRIES: sensor.sensor_schema(
+        SpaSensor,
+        icon="mdi:repeat",
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUMP4_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_PUMP4_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUMP5_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_PUMP5_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    CONF_PUMP6_ENERGY: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_KILOWATT_HOURS,
+        accuracy_decimals=3,
+        device_class=DEVICE_CLASS_ENERGY,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+    ),
+    CONF_PUMP6_RUNTIME: sensor.sensor_schema(
+        SpaSensor,
+        unit_of_measurement=UNIT_HOUR,
+        accuracy_decimals=2,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+}
 
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(CONF_SPA_ID): cv.use_id(BalboaSpa),
-        cv.Optional(CONF_BLOWER): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_HIGHRANGE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_CIRCULATION): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_RESTMODE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_HEATSTATE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_CLOCK_HOUR): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_CLOCK_MINUTE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER1_START_HOUR): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER1_START_MINUTE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER1_DURATION_HOUR): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER1_DURATION_MINUTE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER2_START_HOUR): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER2_START_MINUTE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER2_DURATION_HOUR): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER2_DURATION_MINUTE): sensor.sensor_schema(
-            SpaSensor,
-        ),
-        cv.Optional(CONF_FILTER1_RUNTIME_HOURS): sensor.sensor_schema(
-            SpaSensor,
-            unit_of_measurement="h",
-            icon="mdi:clock-outline",
-        ),
-        cv.Optional(CONF_FILTER2_RUNTIME_HOURS): sensor.sensor_schema(
-            SpaSensor,
-            unit_of_measurement="h",
-            icon="mdi:clock-outline",
-        ),
-        cv.Optional(CONF_FILTER1_CYCLES_COMPLETED): sensor.sensor_schema(
-            SpaSensor,
-            icon="mdi:counter",
-        ),
-        cv.Optional(CONF_FILTER2_CYCLES_COMPLETED): sensor.sensor_schema(
-            SpaSensor,
-            icon="mdi:counter",
-        ),
-        cv.Optional(CONF_FILTER1_CURRENT_RUNTIME_MINUTES): sensor.sensor_schema(
-            SpaSensor,
-            unit_of_measurement="min",
-            icon="mdi:timer",
-        ),
-        cv.Optional(CONF_FILTER2_CURRENT_RUNTIME_MINUTES): sensor.sensor_schema(
-            SpaSensor,
-            unit_of_measurement="min",
-            icon="mdi:timer",
-        ),
+    }).extend({
+        cv.Optional(sensor_type): schema.extend(PUBLISH_LIMIT_SCHEMA) for sensor_type, schema in SENSOR_TYPES.items()
     })
 
 async def to_code(config):
     parent = await cg.get_variable(config[CONF_SPA_ID])
 
-    for sensor_type in [CONF_BLOWER, CONF_HIGHRANGE, CONF_CIRCULATION, CONF_RESTMODE, CONF_HEATSTATE, CONF_CLOCK_HOUR, CONF_CLOCK_MINUTE, CONF_FILTER1_START_HOUR, CONF_FILTER1_START_MINUTE, CONF_FILTER1_DURATION_HOUR, CONF_FILTER1_DURATION_MINUTE, CONF_FILTER2_START_HOUR, CONF_FILTER2_START_MINUTE, CONF_FILTER2_DURATION_HOUR, CONF_FILTER2_DURATION_MINUTE, CONF_FILTER1_RUNTIME_HOURS, CONF_FILTER2_RUNTIME_HOURS, CONF_FILTER1_CYCLES_COMPLETED, CONF_FILTER2_CYCLES_COMPLETED, CONF_FILTER1_CURRENT_RUNTIME_MINUTES, CONF_FILTER2_CURRENT_RUNTIME_MINUTES]:
+    for sensor_type in SENSOR_TYPES:
         if conf := config.get(sensor_type):
             var = await sensor.new_sensor(conf)
             cg.add(var.set_parent(parent))
             sensor_type_value = getattr(SpaSensorTypeEnum, sensor_type.upper())
             cg.add(var.set_sensor_type(sensor_type_value))
+            if conf[CONF_MIN_PUBLISH_INTERVAL].total_milliseconds > 0 or conf[CONF_DEADBAND] > 0:
+                cg.add(var.set_publish_limit(conf[CONF_MIN_PUBLISH_INTERVAL], conf[CONF_DEADBAND]))
@@ -6,97 +6,51 @@ namespace balboa_spa {
 
 static const char *TAG = "BalboaSpa.sensors";
 
+// 254 is used by SpaState to indicate no value yet
+static float no_value_if_unset(uint8_t value) { return value == 254 ? NAN : value; }
+
+// One accessor per BalboaSpaSensorType, indexed by the enum value
+#define BALBOA_SPA_SENSOR_ACCESSOR(name, ...) __VA_ARGS__,
+static const BalboaSpaSensors::Accessor SENSOR_ACCESSORS[] = {
+    nullptr,  // BalboaSpaSensorType::NONE
+    BALBOA_SPA_SENSOR_TYPES(BALBOA_SPA_SENSOR_ACCESSOR)
+};
+#undef BALBOA_SPA_SENSOR_ACCESSOR
+
 void BalboaSpaSensors::set_parent(BalboaSpa *parent) {
     this->parent = parent;
-    parent->register_listener([this](SpaState* spaState){ this->update(spaState); });
+    parent->register_listener([this](SpaState* spaState){ this->update(spaState); }, sizeof(*this));
+}
+
+void BalboaSpaSensors::set_sensor_type(BalboaSpaSensorType _type) {
+    sensor_type = _type;
+    auto index = static_cast<uint8_t>(_type);
+    accessor = index < static_cast<uint8_t>(BalboaSpaSensorType::SENSOR_TYPE_COUNT) ? SENSOR_ACCESSORS[index] : nullptr;
+    if (accessor == nullptr) {
+        ESP_LOGW(TAG, "Unknown sensor type: %d", index);
+    }
+}
+
+void BalboaSpaSensors::set_publish_limit(uint32_t min_interval_ms, float deadband) {
+    limit_slot = parent->get_publish_limiter().add(min_interval_ms, deadband);
 }
 
 void BalboaSpaSensors::update(SpaState* spaState) {
     // Early return if parent is null or not communicating
-    if (parent == nullptr || !parent->is_communicating()) {
+    if (accessor == nullptr || parent == nullptr || !parent->is_communicating()) {
         return;
     }
 
-    uint8_t sensor_state_value;
+    float sensor_state_value = accessor(*parent, *spaState);
+    if (std::isnan(sensor_state_value)) {
+        return;
+    }
 
-    switch (sensor_type)
-    {
-        case BalboaSpaSensorType::BLOWER:
-            sensor_state_value = spaState->blower;
-            break;
-        case BalboaSpaSensorType::HIGHRANGE:
-            sensor_state_value = spaState->highrange;
-            break;
-        case BalboaSpaSensorType::CIRCULATION:
-            sensor_state_value = spaState->circulation;
-            break;
-        case BalboaSpaSensorType::RESTMODE:
-            sensor_state_value = spaState->rest_mode;
-            if(sensor_state_value == 254)
-            {
-                // This indicate no value
-                return;
-            }
-            break;
-        case BalboaSpaSensorType::HEATSTATE:
-            sensor_state_value = spaState->heat_state;
-            if(sensor_state_value == 254)
-            {
-                // no value
-                return;
-            }
-            break;
-        case BalboaSpaSensorType::SPA_CLOCK_HOUR:
-            sensor_state_value = spaState->hour;
-            break;
-        case BalboaSpaSensorType::SPA_CLOCK_MINUTE:
-            sensor_state_value = spaState->minutes;
-            break;
-        case BalboaSpaSensorType::FILTER1_START_HOUR:
-            sensor_state_value = parent->get_filter1_start_hour();
-            break;
-        case BalboaSpaSensorType::FILTER1_START_MINUTE:
-            sensor_state_value = parent->get_filter1_start_minute();
-            break;
-        case BalboaSpaSensorType::FILTER1_DURATION_HOUR:
-            sensor_state_value = parent->get_filter1_duration_hour();
-            break;
-        case BalboaSpaSensorType::FILTER1_DURATION_MINUTE:
-            sensor_state_value = parent->get_filter1_duration_minute();
-            break;
-        case BalboaSpaSensorType::FILTER2_START_HOUR:
-            sensor_state_value = parent->get_filter2_start_hour();
-            break;
-        case BalboaSpaSensorType::FILTER2_START_MINUTE:
-            sensor_state_value = parent->get_filter2_start_minute();
-            break;
-        case BalboaSpaSensorType::FILTER2_DURATION_HOUR:
-            sensor_state_value = parent->get_filter2_duration_hour();
-            break;
-        case BalboaSpaSensorType::FILTER2_DURATION_MINUTE:
-            sensor_state_value = parent->get_filter2_duration_minute();
-            break;
-        case BalboaSpaSensorType::FILTER1_RUNTIME_HOURS:
-            sensor_state_value = parent->get_filter1_runtime_hours();
-            break;
-        case BalboaSpaSensorType::FILTER2_RUNTIME_HOURS:
-            sensor_state_value = parent->get_filter2_runtime_hours();
-            break;
-        case BalboaSpaSensorType::FILTER1_CYCLES_COMPLETED:
-            sensor_state_value = parent->get_filter1_cycles_completed();
-            break;
-        case BalboaSpaSensorType::FILTER2_CYCLES_COMPLETED:
-            sensor_state_value = parent->get_filter2_cycles_completed();
-            break;
-        case BalboaSpaSensorType::FILTER1_CURRENT_RUNTIME_MINUTES:
-            sensor_state_value = parent->get_filter1_current_runtime_minutes();
-            break;
-        case BalboaSpaSensorType::FILTER2_CURRENT_RUNTIME_MINUTES:
-            sensor_state_value = parent->get_filter2_current_runtime_minutes();
-            break;
-        default:
-            ESP_LOGD(TAG, "Unknown sensor type: %d", sensor_type);
-            return;
+    if (limit_slot != PublishLimiter::NO_SLOT) {
+        if (parent->get_publish_limiter().check_value(limit_slot, sensor_state_value, millis())) {
+            this->publish_state(sensor_state_value);
+        }
+        return;
     }
 
     // Only publish if state has changed
@@ -105,4 +59,4 @@ void BalboaSpaSensors::update(SpaState* spaState) {
         this->publish_state(sensor_state_value);
     }
 }
-}}
\ No newline at end of file
+}}
@@ -8,42 +8,114 @@
 namespace esphome {
 namespace balboa_spa {
 
+// Every sensor type and how its value is read, in enum order; the enum and the accessor table
+// are both expanded from this list, so they cannot drift apart. To add a sensor, add a row here
+// and a schema in sensor/__init__.py whose key upper-cased is the name. Accessors return NAN
+// when there is no value to publish.
+#define BALBOA_SPA_SENSOR_TYPES(X) \
+  X(BLOWER, [](const BalboaSpa &, const SpaState &s) -> float { return s.blower; }) \
+  X(HIGHRANGE, [](const BalboaSpa &, const SpaState &s) -> float { return s.highrange; }) \
+  X(CIRCULATION, [](const BalboaSpa &, const SpaState &s) -> float { return s.circulation; }) \
+  X(RESTMODE, [](const BalboaSpa &, const SpaState &s) -> float { return no_value_if_unset(s.rest_mode); }) \
+  X(HEATSTATE, [](const BalboaSpa &, const SpaState &s) -> float { return no_value_if_unset(s.heat_state); }) \
+  X(SPA_CLOCK_HOUR, [](const BalboaSpa &, const SpaState &s) -> float { return s.hour; }) \
+  X(SPA_CLOCK_MINUTE, [](const BalboaSpa &, const SpaState &s) -> float { return s.minutes; }) \
+  X(FILTER1_START_HOUR, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter1_start_hour(); }) \
+  X(FILTER1_START_MINUTE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter1_start_minute(); }) \
+  X(FILTER1_DURATION_HOUR, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter1_duration_hour(); }) \
+  X(FILTER1_DURATION_MINUTE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter1_duration_minute(); }) \
+  X(FILTER2_START_HOUR, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter2_start_hour(); }) \
+  X(FILTER2_START_MINUTE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter2_start_minute(); }) \
+  X(FILTER2_DURATION_HOUR, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter2_duration_hour(); }) \
+  X(FILTER2_DURATION_MINUTE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter2_duration_minute(); }) \
+  X(FILTER1_RUNTIME_HOURS, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter1_runtime_hours(); }) \
+  X(FILTER2_RUNTIME_HOURS, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter2_runtime_hours(); }) \
+  X(FILTER1_CYCLES_COMPLETED, [](const BalboaSpa &, const SpaState &s) -> float { return s.filter1_cycles_completed; }) \
+  X(FILTER2_CYCLES_COMPLETED, [](const BalboaSpa &, const SpaState &s) -> float { return s.filter2_cycles_completed; }) \
+  X(FILTER1_CURRENT_RUNTIME_MINUTES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter1_current_runtime_minutes(); }) \
+  X(FILTER2_CURRENT_RUNTIME_MINUTES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter2_current_runtime_minutes(); }) \
+  X(FILTER_COUNTER_WRITES_TODAY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_filter_counter_writes_today(); }) \
+  X(HEATING_RATE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_heating_rate(); }) \
+  X(COOLING_RATE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_cooling_rate(); }) \
+  X(TIME_TO_TARGET, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_minutes_to_target(); }) \
+  X(ENERGY_TOTAL, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().total_kwh(); }) \
+  X(ENERGY_TODAY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().today_kwh(); }) \
+  X(HEATER_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_HEATER); }) \
+  X(HEATER_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_HEATER); }) \
+  X(PUMP1_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_PUMP1); }) \
+  X(PUMP1_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_PUMP1); }) \
+  X(PUMP2_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_PUMP2); }) \
+  X(PUMP2_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_PUMP2); }) \
+  X(PUMP3_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_PUMP3); }) \
+  X(PUMP3_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_PUMP3); }) \
+  X(BLOWER_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_BLOWER); }) \
+  X(BLOWER_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_BLOWER); }) \
+  X(CIRCULATION_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_CIRCULATION); }) \
+  X(CIRCULATION_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_CIRCULATION); }) \
+  X(TOGGLE_CONVERGENCE_TIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_toggle_reconciler().last_convergence_seconds(); }) \
+  X(TOGGLE_RETRIES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_toggle_reconciler().retries(); }) \
+  X(TOGGLE_FAILURES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_toggle_reconciler().failures(); }) \
+  X(WRITES_CONFIRMED, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_writes_confirmed(); }) \
+  X(WRITES_RETRIED, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_writes_retried(); }) \
+  X(WRITES_ABANDONED, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_writes_abandoned(); }) \
+  X(CLOCK_ERROR, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_clock_error(); }) \
+  X(CLOCK_DRIFT, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_clock_drift(); }) \
+  X(BUS_BYTES_LOST, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bytes_lost(); }) \
+  X(BUS_RESYNC_TIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_last_resync_ms(); }) \
+  X(BUS_COLLISIONS, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bus_collisions(); }) \
+  X(BUS_RETRANSMITS, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bus_retransmits(); }) \
+  X(BUS_TURNAROUND, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bus_turnaround_us(); }) \
+  X(BUS_STATUS_PERIOD, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bus_timing().status_period_ms(); }) \
+  X(BUS_CTS_PERIOD, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bus_timing().cts_period_ms(); }) \
+  X(BUS_REPLY_LATENCY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_bus_timing().reply_latency_us(); }) \
+  X(BUS_CRC_ERRORS, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_crc_errors(); }) \
+  X(BUS_OVERSIZED_FRAMES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_oversized_frames(); }) \
+  X(BUS_TRUNCATED_FRAMES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_truncated_frames(); }) \
+  X(BUS_SHORT_FRAMES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_short_frames(); }) \
+  X(BUS_LONG_FRAMES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_long_frames(); }) \
+  X(PUBLISHES_SUPPRESSED, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_publish_limiter().suppressed(); }) \
+  X(BOOT_TO_FIRST_STATE, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_boot_to_first_state_ms(); }) \
+  X(BOOT_TO_POPULATED, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_boot_to_populated_ms(); }) \
+  X(BOOT_TO_READY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_boot_to_ready_ms(); }) \
+  X(CONFIGURATION_REQUEST_RETRIES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_discovery_retries(SpaDiscovery::CONFIGURATION); }) \
+  X(FILTER_CYCLES_REQUEST_RETRIES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_discovery_retries(SpaDiscovery::FILTER_CYCLES); }) \
+  X(INFORMATION_REQUEST_RETRIES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_discovery_retries(SpaDiscovery::INFORMATION); }) \
+  X(PREFERENCES_REQUEST_RETRIES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_discovery_retries(SpaDiscovery::PREFERENCES); }) \
+  X(FAULT_LOG_REQUEST_RETRIES, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_discovery_retries(SpaDiscovery::FAULT_LOG); }) \
+  X(PUMP4_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_PUMP4); }) \
+  X(PUMP4_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_PUMP4); }) \
+  X(PUMP5_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_PUMP5); }) \
+  X(PUMP5_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_PUMP5); }) \
+  X(PUMP6_ENERGY, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().energy_kwh(LOAD_PUMP6); }) \
+  X(PUMP6_RUNTIME, [](const BalboaSpa &spa, const SpaState &) -> float { return spa.get_energy_meter().runtime_hours(LOAD_PUMP6); })
+
 class BalboaSpaSensors : public sensor::Sensor {
 public:
-  enum class BalboaSpaSensorType : uint8_t{
-    BLOWER = 1,
-    HIGHRANGE = 2,
-    CIRCULATION = 3,
-    RESTMODE = 4,
-    HEATSTATE = 5,
-    SPA_CLOCK_HOUR = 6,
-    SPA_CLOCK_MINUTE = 7,
-    FILTER1_START_HOUR = 8,
-    FILTER1_START_MINUTE = 9,
-    FILTER1_DURATION_HOUR = 10,
-    FILTER1_DURATION_MINUTE = 11,
-    FILTER2_START_HOUR = 12,
-    FILTER2_START_MINUTE = 13,
-    FILTER2_DURATION_HOUR = 14,
-    FILTER2_DURATION_MINUTE = 15,
-    FILTER1_RUNTIME_HOURS = 16,
-    FILTER2_RUNTIME_HOURS = 17,
-    FILTER1_CYCLES_COMPLETED = 18,
-    FILTER2_CYCLES_COMPLETED = 19,
-    FILTER1_CURRENT_RUNTIME_MINUTES = 20,
-    FILTER2_CURRENT_RUNTIME_MINUTES = 21,
+#define BALBOA_SPA_SENSOR_ENUM(name, ...) name,
+  enum class BalboaSpaSensorType : uint8_t {
+    NONE = 0,  // not a valid type
+    BALBOA_SPA_SENSOR_TYPES(BALBOA_SPA_SENSOR_ENUM)
+    SENSOR_TYPE_COUNT  // keep last, sizes the accessor table
   };
+#undef BALBOA_SPA_SENSOR_ENUM
+
+  // Reads one value out of the spa; returns NAN when there is no value to publish
+  using Accessor = float (*)(const BalboaSpa &spa, const SpaState &spaState);
 
 public:
   BalboaSpaSensors() {};
   void update(SpaState* spaState);
 
   void set_parent(BalboaSpa *parent);
-  void set_sensor_type(BalboaSpaSensorType _type) { sensor_type = _type;  }
+  void set_sensor_type(BalboaSpaSensorType _type);
+  // Call after set_parent(); the parent applies the limit
+  void set_publish_limit(uint32_t min_interval_ms, float deadband);
 
   private:
     BalboaSpaSensorType sensor_type;
-    BalboaSpa *parent;
+    Accessor accessor = nullptr;
+    BalboaSpa *parent = nullptr;
+    PublishLimiter::Slot limit_slot = PublishLimiter::NO_SLOT;
 };
 
 }  // namespace balboa_spa
@@ -6,6 +6,30 @@
 
 namespace esphome {
 namespace balboa_spa {
+// Equipment bits derived from SpaConfig, used to skip work for hardware the spa does not have
+enum SpaEquipment : uint16_t {
+    EQUIPMENT_NONE = 0,
+    EQUIPMENT_PUMP1 = 1 << 0,
+    EQUIPMENT_PUMP2 = 1 << 1,
+    EQUIPMENT_PUMP3 = 1 << 2,
+    EQUIPMENT_PUMP4 = 1 << 3,
+    EQUIPMENT_PUMP5 = 1 << 4,
+    EQUIPMENT_PUMP6 = 1 << 5,
+    EQUIPMENT_LIGHT1 = 1 << 6,
+    EQUIPMENT_LIGHT2 = 1 << 7,
+    EQUIPMENT_CIRCULATION = 1 << 8,
+    EQUIPMENT_BLOWER = 1 << 9,
+    EQUIPMENT_MISTER = 1 << 10,
+    EQUIPMENT_AUX1 = 1 << 11,
+    EQUIPMENT_AUX2 = 1 << 12,
+    EQUIPMENT_ALL = 0x1FFF
+};
+
+// EQUIPMENT_NONE marks things every spa has, such as temperatures
+inline bool spa_has_equipment(uint16_t present, uint16_t equipment) {
+    return equipment == EQUIPMENT_NONE || (present & equipment) != 0;
+}
+
 struct SpaConfig {
     public:
         uint8_t pump1 :2; //this could be 1=1 speed; 2=2 speeds
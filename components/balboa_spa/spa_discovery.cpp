@@ -0,0 +1,90 @@
+#include "spa_discovery.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+// Settings request payloads, indexed by Request
+static const uint8_t REQUEST_PAYLOADS[SpaDiscovery::REQUEST_COUNT][3] = {
+    {0x00, 0x00, 0x01},  // configuration
+    {0x01, 0x00, 0x00},  // filter cycles
+    {0x02, 0x00, 0x00},  // information
+    {0x08, 0x00, 0x00},  // preferences
+    {0x20, 0xFF, 0x00},  // fault log, latest entry
+};
+
+static const char *const REQUEST_NAMES[SpaDiscovery::REQUEST_COUNT] = {
+    "configuration", "filter cycles", "information", "preferences", "fault log",
+};
+
+const char *SpaDiscovery::name(Request request) {
+    return request < REQUEST_COUNT ? REQUEST_NAMES[request] : "none";
+}
+
+const uint8_t *SpaDiscovery::payload(Request request) { return REQUEST_PAYLOADS[request]; }
+
+void SpaDiscovery::restart() {
+    for (auto &entry : entries_) {
+        entry.phase = WANTED;
+        entry.attempts = 0;
+    }
+}
+
+void SpaDiscovery::refresh(Request request) {
+    Entry &entry = entries_[request];
+    if (entry.phase == IDLE) {
+        entry.phase = WANTED;
+        entry.attempts = 0;
+    }
+}
+
+void SpaDiscovery::expire(uint32_t now) {
+    for (auto &entry : entries_) {
+        if (entry.phase == IN_FLIGHT && now - entry.since >= RESPONSE_TIMEOUT_MS) {
+            if (entry.attempts > max_retries_) {
+                entry.phase = RESTING;
+                entry.since = now;
+            } else {
+                entry.phase = WANTED;
+                entry.retries++;
+            }
+        } else if (entry.phase == RESTING && now - entry.since >= BACKOFF_MS) {
+            entry.phase = WANTED;
+            entry.attempts = 0;
+            entry.retries++;
+        }
+    }
+}
+
+SpaDiscovery::Request SpaDiscovery::next(uint32_t now) {
+    expire(now);
+    for (uint8_t i = 0; i < REQUEST_COUNT; i++) {
+        Entry &entry = entries_[i];
+        if (entry.phase == WANTED) {
+            entry.phase = IN_FLIGHT;
+            entry.attempts++;
+            entry.since = now;
+            return static_cast<Request>(i);
+        }
+    }
+    return REQUEST_COUNT;
+}
+
+void SpaDiscovery::on_response(Request request) {
+    Entry &entry = entries_[request];
+    // An unsolicited answer is as good as one we asked for
+    entry.received = true;
+    entry.phase = IDLE;
+    entry.attempts = 0;
+}
+
+bool SpaDiscovery::ready() const {
+    for (const auto &entry : entries_) {
+        if (!entry.received) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * The settings requests (BF 22) sent after a client ID was assigned.
+ *
+ * Requests do not depend on each other, so one is handed out at every
+ * clear-to-send while others are still waiting for their answer. A request
+ * without an answer within RESPONSE_TIMEOUT_MS is sent again, up to
+ * max_retries times; after that it rests for BACKOFF_MS and starts over, so
+ * a lost response never stalls discovery for good. Every resend counts as a
+ * retry. Discovery is ready once each request has been answered at least once.
+ */
+class SpaDiscovery {
+  public:
+    // In the order they are sent; the configuration decides how status frames are decoded
+    enum Request : uint8_t {
+        CONFIGURATION,
+        FILTER_CYCLES,
+        INFORMATION,
+        PREFERENCES,
+        FAULT_LOG,
+        REQUEST_COUNT,  // keep last; also means "nothing to send"
+    };
+
+    static const uint32_t RESPONSE_TIMEOUT_MS = 2000;
+    static const uint32_t BACKOFF_MS = 30000;
+
+    void set_max_retries(uint8_t retries) { max_retries_ = retries; }
+
+    // Wants every request again, e.g. after a new client ID; answers already received stay valid
+    void restart();
+    // Asks again at the next clear-to-send unless the request is already waiting for its answer
+    void refresh(Request request);
+    // Called at clear-to-send; returns the request to send now or REQUEST_COUNT
+    Request next(uint32_t now);
+    // Called for every response of the request's type, asked for or not
+    void on_response(Request request);
+
+    bool received(Request request) const { return entries_[request].received; }
+    bool ready() const;
+    // Sends of the current round, 1 for the first
+    uint8_t attempts(Request request) const { return entries_[request].attempts; }
+    uint32_t retries(Request request) const { return entries_[request].retries; }
+
+    static const char *name(Request request);
+    // The three bytes after BF 22
+    static const uint8_t *payload(Request request);
+
+  private:
+    enum Phase : uint8_t {
+        WANTED,
+        IN_FLIGHT,
+        RESTING,  // out of retries, waiting for BACKOFF_MS
+        IDLE,
+    };
+
+    struct Entry {
+        Phase phase = WANTED;
+        bool received = false;
+        uint8_t attempts = 0;
+        uint32_t since = 0;  // when it was sent, or started resting
+        uint32_t retries = 0;
+    };
+
+    void expire(uint32_t now);
+
+    Entry entries_[REQUEST_COUNT];
+    uint8_t max_retries_ = 3;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,84 @@
+#include "spa_history.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+void SpaHistory::allocate(uint16_t minutes) {
+    capacity_ = minutes;
+    head_ = 0;
+    count_ = 0;
+    if (minutes == 0) {
+        storage_.reset();
+        temp_min_ = temp_max_ = temp_avg_ = heat_percent_ = loads_ = loads_high_ = nullptr;
+        return;
+    }
+    storage_.reset(new uint8_t[static_cast<size_t>(minutes) * FIELD_COUNT]);
+    temp_min_ = storage_.get();
+    temp_max_ = temp_min_ + minutes;
+    temp_avg_ = temp_max_ + minutes;
+    heat_percent_ = temp_avg_ + minutes;
+    loads_ = heat_percent_ + minutes;
+    loads_high_ = loads_ + minutes;
+}
+
+void SpaHistory::sample(uint32_t now, uint8_t temp_half_c, bool heating, uint16_t loads) {
+    if (!enabled()) {
+        return;
+    }
+
+    if (samples_ == 0) {
+        minute_start_ = now;
+    } else if (now - minute_start_ >= MINUTE_MS) {
+        uint32_t elapsed_minutes = (now - minute_start_) / MINUTE_MS;
+        commit_minute();
+        // Minutes without any samples (e.g. lost communication) are stored as gaps
+        for (uint32_t gap = 1; gap < elapsed_minutes && gap <= capacity_; gap++) {
+            push(NO_SAMPLE, NO_SAMPLE, NO_SAMPLE, NO_SAMPLE, 0);
+        }
+        minute_start_ += elapsed_minutes * MINUTE_MS;
+    }
+
+    if (samples_ < UINT8_MAX) {
+        samples_++;
+        heat_samples_ += heating;
+        if (temp_half_c != NO_SAMPLE) {
+            temp_sum_ += temp_half_c;
+            temp_samples_++;
+            if (minute_min_ == NO_SAMPLE || temp_half_c < minute_min_) minute_min_ = temp_half_c;
+            if (temp_half_c > minute_max_) minute_max_ = temp_half_c;
+        }
+    }
+    minute_loads_ |= loads;
+}
+
+void SpaHistory::commit_minute() {
+    if (temp_samples_ > 0) {
+        push(minute_min_, minute_max_, (temp_sum_ + temp_samples_ / 2) / temp_samples_,
+             (heat_samples_ * 100 + samples_ / 2) / samples_, minute_loads_);
+    } else {
+        push(NO_SAMPLE, NO_SAMPLE, NO_SAMPLE, (heat_samples_ * 100 + samples_ / 2) / samples_, minute_loads_);
+    }
+    temp_sum_ = 0;
+    temp_samples_ = 0;
+    samples_ = 0;
+    heat_samples_ = 0;
+    minute_min_ = NO_SAMPLE;
+    minute_max_ = 0;
+    minute_loads_ = 0;
+}
+
+void SpaHistory::push(uint8_t tmin, uint8_t tmax, uint8_t tavg, uint8_t heat, uint16_t loads) {
+    temp_min_[head_] = tmin;
+    temp_max_[head_] = tmax;
+    temp_avg_[head_] = tavg;
+    heat_percent_[head_] = heat;
+    loads_[head_] = loads & 0xFF;
+    loads_high_[head_] = loads >> 8;
+    head_ = (head_ + 1) % capacity_;
+    if (count_ < capacity_) {
+        count_++;
+    }
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
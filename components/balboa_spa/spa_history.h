@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+
+namespace esphome {
+namespace balboa_spa {
+
+// Pump/load bits stored per history minute; a bit is set if the load ran at any point in that minute
+static const uint16_t HISTORY_LOAD_PUMP1 = 0x0001;
+static const uint16_t HISTORY_LOAD_PUMP2 = 0x0002;
+static const uint16_t HISTORY_LOAD_PUMP3 = 0x0004;
+static const uint16_t HISTORY_LOAD_BLOWER = 0x0008;
+static const uint16_t HISTORY_LOAD_CIRCULATION = 0x0010;
+static const uint16_t HISTORY_LOAD_LIGHT = 0x0020;
+static const uint16_t HISTORY_LOAD_PUMP4 = 0x0040;
+static const uint16_t HISTORY_LOAD_PUMP5 = 0x0080;
+static const uint16_t HISTORY_LOAD_PUMP6 = 0x0100;
+
+/**
+ * Fixed-size ring of per-minute spa history, stored as one array per field
+ * so that each field can be read out as a contiguous run.
+ *
+ * Temperatures are half-degree Celsius integers (value / 2 = degrees C),
+ * heater time is a 0-100 percentage of the minute. Load bits take two
+ * arrays, the low and high byte. Minutes without a temperature reading hold
+ * NO_SAMPLE.
+ */
+class SpaHistory {
+  public:
+    static const uint8_t NO_SAMPLE = 0xFF;
+    static const uint32_t MINUTE_MS = 60000;
+
+    // Allocates storage for the given number of minutes; 0 disables the history
+    void allocate(uint16_t minutes);
+    bool enabled() const { return capacity_ != 0; }
+    uint16_t capacity() const { return capacity_; }
+    uint16_t size() const { return count_; }
+    // The single allocation holding every field for every minute
+    size_t heap_bytes() const { return static_cast<size_t>(capacity_) * FIELD_COUNT; }
+
+    // Feed one sample; closes the current minute (and any skipped minutes) when it has elapsed
+    void sample(uint32_t now, uint8_t temp_half_c, bool heating, uint16_t loads);
+
+    // Index 0 is the oldest stored minute, size() - 1 the most recent one
+    uint8_t temp_min(uint16_t index) const { return temp_min_[slot(index)]; }
+    uint8_t temp_max(uint16_t index) const { return temp_max_[slot(index)]; }
+    uint8_t temp_avg(uint16_t index) const { return temp_avg_[slot(index)]; }
+    uint8_t heat_percent(uint16_t index) const { return heat_percent_[slot(index)]; }
+    uint16_t loads(uint16_t index) const { return loads_[slot(index)] | loads_high_[slot(index)] << 8; }
+
+  private:
+    static const uint8_t FIELD_COUNT = 6;
+
+    std::unique_ptr<uint8_t[]> storage_;
+    uint8_t *temp_min_ = nullptr;
+    uint8_t *temp_max_ = nullptr;
+    uint8_t *temp_avg_ = nullptr;
+    uint8_t *heat_percent_ = nullptr;
+    uint8_t *loads_ = nullptr;
+    uint8_t *loads_high_ = nullptr;
+    uint16_t capacity_ = 0;
+    uint16_t head_ = 0;  // next slot to write
+    uint16_t count_ = 0;
+
+    // Accumulator for the minute in progress
+    uint32_t minute_start_ = 0;
+    uint16_t temp_sum_ = 0;
+    uint8_t temp_samples_ = 0;
+    uint8_t samples_ = 0;
+    uint8_t heat_samples_ = 0;
+    uint8_t minute_min_ = NO_SAMPLE;
+    uint8_t minute_max_ = 0;
+    uint16_t minute_loads_ = 0;
+
+    uint16_t slot(uint16_t index) const { return (head_ + capacity_ - count_ + index) % capacity_; }
+    void commit_minute();
+    void push(uint8_t tmin, uint8_t tmax, uint8_t tavg, uint8_t heat, uint16_t loads);
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
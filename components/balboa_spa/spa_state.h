@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <cmath>
 
 #ifndef SPA_STATE_H
 #define SPA_STATE_H
@@ -13,8 +14,8 @@ class SpaState {
             heat_state = 254;
             target_temp = NAN;
             current_temp = NAN;
-            filter1_runtime_hours = 0;
-            filter2_runtime_hours = 0;
+            filter1_runtime_seconds = 0;
+            filter2_runtime_seconds = 0;
             filter1_cycles_completed = 0;
             filter2_cycles_completed = 0;
         }
@@ -22,11 +23,20 @@ class SpaState {
         uint8_t jet2 :2;
         uint8_t jet3 :2;
         uint8_t jet4 :2;
+        uint8_t jet5 :2;
+        uint8_t jet6 :2;
         uint8_t pump1 :2;  // Pump 1 status (0=off, 1=low, 2=high)
         uint8_t pump2 :2;  // Pump 2 status (0=off, 1=low, 2=high)
         uint8_t pump3 :2;  // Pump 3 status (0=off, 1=low, 2=high)
+        uint8_t pump4 :2;  // Pump 4 status (0=off, 1=low, 2=high)
+        uint8_t pump5 :2;  // Pump 5 status (0=off, 1=low, 2=high)
+        uint8_t pump6 :2;  // Pump 6 status (0=off, 1=low, 2=high)
         uint8_t blower :1;
         uint8_t light :1;
+        uint8_t light2 :1;
+        uint8_t mister :1;
+        uint8_t aux1 :1;
+        uint8_t aux2 :1;
         uint8_t highrange:1;        
         uint8_t circulation:1;
         uint8_t hour:5;
@@ -37,14 +47,16 @@ class SpaState {
         float current_temp;
         
         // Filter status tracking
-        uint16_t filter1_runtime_hours;      // Total runtime hours for filter 1
-        uint16_t filter2_runtime_hours;      // Total runtime hours for filter 2
+        uint32_t filter1_runtime_seconds;    // Total runtime seconds for filter 1
+        uint32_t filter2_runtime_seconds;    // Total runtime seconds for filter 2
         uint16_t filter1_cycles_completed;   // Number of completed filter cycles
         uint16_t filter2_cycles_completed;   // Number of completed filter cycles
         bool filter1_running;                // Current filter 1 running status
         bool filter2_running;                // Current filter 2 running status
         uint32_t filter1_last_start_time;    // Last start time for filter 1 (millis)
         uint32_t filter2_last_start_time;    // Last start time for filter 2 (millis)
+        uint32_t filter1_accounted_time;     // Runtime credited up to this time for filter 1 (millis)
+        uint32_t filter2_accounted_time;     // Runtime credited up to this time for filter 2 (millis)
 };
 }  // namespace balboa_spa
 }  // namespace esphome
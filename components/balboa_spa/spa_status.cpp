@@ -0,0 +1,92 @@
+#include "spa_status.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+void apply_status(const protocol::StatusMessage &status, uint16_t equipment_present, SpaState &state) {
+    auto present = [equipment_present](uint16_t equipment) { return spa_has_equipment(equipment_present, equipment); };
+
+    state.rest_mode = status.rest_mode;
+    state.heat_state = status.heat_state;
+    state.highrange = status.high_range;
+
+    // A jet is on at either speed
+    if (present(EQUIPMENT_PUMP1)) state.jet1 = status.pumps[0] != 0;
+    if (present(EQUIPMENT_PUMP2)) state.jet2 = status.pumps[1] != 0;
+    if (present(EQUIPMENT_PUMP3)) state.jet3 = status.pumps[2] != 0;
+    if (present(EQUIPMENT_PUMP4)) state.jet4 = status.pumps[3] != 0;
+    if (present(EQUIPMENT_PUMP5)) state.jet5 = status.pumps[4] != 0;
+    if (present(EQUIPMENT_PUMP6)) state.jet6 = status.pumps[5] != 0;
+
+    // Circulation is always decoded, some spas do not list it in the configuration
+    state.circulation = status.circulation;
+    if (present(EQUIPMENT_BLOWER)) state.blower = status.blower;
+    if (present(EQUIPMENT_LIGHT1)) state.light = status.light1;
+    if (present(EQUIPMENT_LIGHT2)) state.light2 = status.light2;
+    if (present(EQUIPMENT_MISTER)) state.mister = status.mister;
+    if (present(EQUIPMENT_AUX1)) state.aux1 = status.aux1;
+    if (present(EQUIPMENT_AUX2)) state.aux2 = status.aux2;
+
+    // Speeds: 0 off, 1 low, 2 high
+    state.pump1 = status.pumps[0];
+    state.pump2 = status.pumps[1];
+    if (present(EQUIPMENT_PUMP3)) state.pump3 = status.pumps[2];
+    if (present(EQUIPMENT_PUMP4)) state.pump4 = status.pumps[3];
+    if (present(EQUIPMENT_PUMP5)) state.pump5 = status.pumps[4];
+    if (present(EQUIPMENT_PUMP6)) state.pump6 = status.pumps[5];
+}
+
+// The timestamp only advances by the seconds credited, so no fraction is lost
+// between frames and the unsigned delta stays correct across millis() wrap.
+static bool accumulate_runtime(uint32_t now, uint32_t &runtime_seconds, uint32_t &accounted_time) {
+    uint32_t elapsed_seconds = (now - accounted_time) / 1000;
+    if (elapsed_seconds == 0) {
+        return false;
+    }
+    runtime_seconds += elapsed_seconds;
+    accounted_time += elapsed_seconds * 1000;
+    return true;
+}
+
+// Returns true if the counters changed
+static bool track_filter(bool should_run, uint32_t now, bool &running, uint32_t &runtime_seconds,
+                         uint32_t &accounted_time, uint32_t &last_start_time, uint16_t &cycles_completed,
+                         bool &started, bool &stopped) {
+    bool changed = running && accumulate_runtime(now, runtime_seconds, accounted_time);
+    if (should_run == running) {
+        return changed;
+    }
+    running = should_run;
+    if (should_run) {
+        last_start_time = now;
+        accounted_time = now;
+        started = true;
+        return changed;
+    }
+    cycles_completed++;
+    stopped = true;
+    return true;
+}
+
+FilterRuntimeUpdate update_filter_runtime(const SpaFilterSettings &filters, uint32_t now, SpaState &state) {
+    FilterRuntimeUpdate update;
+    bool filter1_should_run = protocol::filter_cycle_active(
+        filters.filter1_hour, filters.filter1_minute, filters.filter1_duration_hour, filters.filter1_duration_minute,
+        state.hour, state.minutes);
+    bool filter2_should_run = filters.filter2_enable &&
+        protocol::filter_cycle_active(filters.filter2_hour, filters.filter2_minute, filters.filter2_duration_hour,
+                                      filters.filter2_duration_minute, state.hour, state.minutes);
+
+    update.counters_changed |= track_filter(filter1_should_run, now, state.filter1_running,
+                                            state.filter1_runtime_seconds, state.filter1_accounted_time,
+                                            state.filter1_last_start_time, state.filter1_cycles_completed,
+                                            update.started[0], update.stopped[0]);
+    update.counters_changed |= track_filter(filter2_should_run, now, state.filter2_running,
+                                            state.filter2_runtime_seconds, state.filter2_accounted_time,
+                                            state.filter2_last_start_time, state.filter2_cycles_completed,
+                                            update.started[1], update.stopped[1]);
+    return update;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "balboa_protocol.h"
+#include "spa_config.h"
+#include "spa_state.h"
+#include "spa_types.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * The parts of status handling that need nothing from ESPHome, kept out of
+ * BalboaSpa so the host bench times the code the component runs.
+ */
+
+// Copies the equipment of a decoded status frame into state, skipping
+// equipment the configuration did not report. Temperatures and the clock
+// depend on the component's scales and clock tracking, so decodeState()
+// handles those.
+void apply_status(const protocol::StatusMessage &status, uint16_t equipment_present, SpaState &state);
+
+// What update_filter_runtime() changed, for logging and persisting
+struct FilterRuntimeUpdate {
+    bool counters_changed = false;
+    bool started[2] = {false, false};
+    bool stopped[2] = {false, false};
+};
+
+// Runs both filter schedules against the spa clock in state. Runtime is
+// credited in whole seconds while a filter runs, and a cycle is counted when
+// it stops.
+FilterRuntimeUpdate update_filter_runtime(const SpaFilterSettings &filters, uint32_t now, SpaState &state);
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -28,6 +28,14 @@ namespace balboa_spa {
         uint8_t filter2_duration_minute :6;
 
     };
+
+    // Filter counters kept in flash across reboots and OTA updates
+    struct SpaFilterCounters {
+        uint32_t filter1_runtime_seconds;
+        uint32_t filter2_runtime_seconds;
+        uint16_t filter1_cycles_completed;
+        uint16_t filter2_cycles_completed;
+    };
 }  // namespace balboa_spa
 }  // namespace esphome
 
@@ -16,62 +16,56 @@ from .. import (
 
 DEPENDENCIES = ["balboa_spa"]
 
-Jet1Switch = balboa_spa_ns.class_("Jet1Switch", switch.Switch)
-Jet2Switch = balboa_spa_ns.class_("Jet2Switch", switch.Switch)
-Jet3Switch = balboa_spa_ns.class_("Jet3Switch", switch.Switch)
-Jet4Switch = balboa_spa_ns.class_("Jet4Switch", switch.Switch)
-LightsSwitch = balboa_spa_ns.class_("LightsSwitch", switch.Switch)
-BlowerSwitch = balboa_spa_ns.class_("BlowerSwitch", switch.Switch)
+ToggleSwitch = balboa_spa_ns.class_("ToggleSwitch", switch.Switch)
+ToggleSwitchTypeEnum = ToggleSwitch.enum("ToggleSwitchType", True)
 
 
 CONF_JET1 = "jet1"
 CONF_JET2 = "jet2"
 CONF_JET3 = "jet3"
 CONF_JET4 = "jet4"
+CONF_JET5 = "jet5"
+CONF_JET6 = "jet6"
 CONF_LIGHTS = "light"
+CONF_LIGHT2 = "light2"
 CONF_BLOWER = "blower"
+CONF_MISTER = "mister"
+CONF_AUX1 = "aux1"
+CONF_AUX2 = "aux2"
 
+# One entry per ToggleSwitchType; the key upper-cased is the C++ enum name
+SWITCH_TYPES = {
+    CONF_JET1: ICON_FAN,
+    CONF_JET2: ICON_FAN,
+    CONF_JET3: ICON_FAN,
+    CONF_JET4: ICON_FAN,
+    CONF_JET5: ICON_FAN,
+    CONF_JET6: ICON_FAN,
+    CONF_LIGHTS: ICON_LIGHTBULB,
+    CONF_LIGHT2: ICON_LIGHTBULB,
+    CONF_BLOWER: ICON_GRAIN,
+    CONF_MISTER: "mdi:weather-fog",
+    CONF_AUX1: "mdi:toggle-switch",
+    CONF_AUX2: "mdi:toggle-switch",
+}
 
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(CONF_SPA_ID): cv.use_id(BalboaSpa),
-        cv.Optional(CONF_JET1): switch.switch_schema(
-            Jet1Switch,
-            icon=ICON_FAN,
+    }).extend({
+        cv.Optional(switch_type): switch.switch_schema(
+            ToggleSwitch,
+            icon=icon,
             default_restore_mode="DISABLED",
-        ),
-        cv.Optional(CONF_JET2): switch.switch_schema(
-            Jet2Switch,
-            icon=ICON_FAN,
-            default_restore_mode="DISABLED",
-        ),
-        cv.Optional(CONF_JET3): switch.switch_schema(
-            Jet3Switch,
-            icon=ICON_FAN,
-            default_restore_mode="DISABLED",
-        ),
-        cv.Optional(CONF_JET4): switch.switch_schema(
-            Jet4Switch,
-            icon=ICON_FAN,
-            default_restore_mode="DISABLED",
-        ),
-        cv.Optional(CONF_LIGHTS): switch.switch_schema(
-            LightsSwitch,
-            icon=ICON_LIGHTBULB,
-            default_restore_mode="DISABLED",
-        ),
-        cv.Optional(CONF_BLOWER): switch.switch_schema(
-            BlowerSwitch,
-            icon=ICON_GRAIN,
-            default_restore_mode="DISABLED",
-        ),
-
+        )
+        for switch_type, icon in SWITCH_TYPES.items()
     })
 
 async def to_code(config):
     parent = await cg.get_variable(config[CONF_SPA_ID])
 
-    for switch_type in [CONF_JET1, CONF_JET2, CONF_JET3, CONF_JET4, CONF_LIGHTS, CONF_BLOWER]:
+    for switch_type in SWITCH_TYPES:
         if conf := config.get(switch_type):
             sw_var = await switch.new_switch(conf)
+            cg.add(sw_var.set_switch_type(getattr(ToggleSwitchTypeEnum, switch_type.upper())))
             cg.add(sw_var.set_parent(parent))
@@ -0,0 +1,80 @@
+#include "esphome/core/log.h"
+#include "toggle_switch.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+static const char *TAG = "BalboaSpa.switch";
+
+// Indexed by ToggleSwitchType; jets are on at either pump speed
+static const ToggleSwitch::ToggleItem TOGGLE_ITEMS[] = {
+    {"unknown", 0x00, nullptr, EQUIPMENT_NONE},
+    {"jet1", TOGGLE_ITEM_PUMP1, [](const SpaState &s) -> bool { return s.jet1; }, EQUIPMENT_PUMP1},
+    {"jet2", TOGGLE_ITEM_PUMP2, [](const SpaState &s) -> bool { return s.jet2; }, EQUIPMENT_PUMP2},
+    {"jet3", TOGGLE_ITEM_PUMP3, [](const SpaState &s) -> bool { return s.jet3; }, EQUIPMENT_PUMP3},
+    {"jet4", TOGGLE_ITEM_PUMP4, [](const SpaState &s) -> bool { return s.jet4; }, EQUIPMENT_PUMP4},
+    {"jet5", TOGGLE_ITEM_PUMP5, [](const SpaState &s) -> bool { return s.jet5; }, EQUIPMENT_PUMP5},
+    {"jet6", TOGGLE_ITEM_PUMP6, [](const SpaState &s) -> bool { return s.jet6; }, EQUIPMENT_PUMP6},
+    {"light", TOGGLE_ITEM_LIGHT1, [](const SpaState &s) -> bool { return s.light; }, EQUIPMENT_LIGHT1},
+    {"light2", TOGGLE_ITEM_LIGHT2, [](const SpaState &s) -> bool { return s.light2; }, EQUIPMENT_LIGHT2},
+    {"blower", TOGGLE_ITEM_BLOWER, [](const SpaState &s) -> bool { return s.blower; }, EQUIPMENT_BLOWER},
+    {"mister", TOGGLE_ITEM_MISTER, [](const SpaState &s) -> bool { return s.mister; }, EQUIPMENT_MISTER},
+    {"aux1", TOGGLE_ITEM_AUX1, [](const SpaState &s) -> bool { return s.aux1; }, EQUIPMENT_AUX1},
+    {"aux2", TOGGLE_ITEM_AUX2, [](const SpaState &s) -> bool { return s.aux2; }, EQUIPMENT_AUX2},
+};
+
+static_assert(sizeof(TOGGLE_ITEMS) / sizeof(TOGGLE_ITEMS[0]) ==
+                  static_cast<size_t>(ToggleSwitch::ToggleSwitchType::TOGGLE_SWITCH_TYPE_COUNT),
+              "TOGGLE_ITEMS must have one entry per ToggleSwitchType");
+
+void ToggleSwitch::set_switch_type(ToggleSwitchType _type) {
+    auto index = static_cast<uint8_t>(_type);
+    if (index == 0 || index >= static_cast<uint8_t>(ToggleSwitchType::TOGGLE_SWITCH_TYPE_COUNT)) {
+        ESP_LOGW(TAG, "Unknown switch type: %d", index);
+        item = nullptr;
+        return;
+    }
+    item = &TOGGLE_ITEMS[index];
+}
+
+void ToggleSwitch::update(SpaState* spaState) {
+    if (item == nullptr) {
+        return;
+    }
+
+    // Only update if state has changed
+    bool is_on = item->is_on(*spaState);
+    if(this->state != is_on)
+    {
+        this->publish_state(is_on);
+    }
+}
+
+void ToggleSwitch::set_parent(BalboaSpa *parent) {
+    spa = parent;
+    // Not updated at all when the spa reports it does not have this item
+    parent->register_listener([this](SpaState* spaState){ this->update(spaState); }, sizeof(*this),
+                              item != nullptr ? item->equipment : EQUIPMENT_NONE);
+}
+
+void ToggleSwitch::write_state(bool state) {
+    if (item == nullptr) {
+        return;
+    }
+
+    // Check communication before attempting to control
+    if (!spa->is_communicating()) {
+        ESP_LOGW(TAG, "Cannot control %s - spa not communicating", item->name);
+        return;
+    }
+    if (!spa->has_equipment(item->equipment)) {
+        ESP_LOGW(TAG, "Cannot control %s - not present on this spa", item->name);
+        return;
+    }
+
+    // The spa only toggles; the reconciler keeps toggling until the status matches
+    spa->set_item_state(item->toggle_code, state);
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
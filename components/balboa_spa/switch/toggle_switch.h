@@ -0,0 +1,52 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/switch/switch.h"
+#include "../balboaspa.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+// One switch class for every item the spa controls with a BF 11 toggle.
+// The item code and the SpaState field it reflects come from a table keyed by type.
+class ToggleSwitch : public switch_::Switch {
+ public:
+  enum class ToggleSwitchType : uint8_t {
+    UNKNOWN = 0,
+    JET1,
+    JET2,
+    JET3,
+    JET4,
+    JET5,
+    JET6,
+    LIGHT,
+    LIGHT2,
+    BLOWER,
+    MISTER,
+    AUX1,
+    AUX2,
+    TOGGLE_SWITCH_TYPE_COUNT  // keep last, sizes the item table
+  };
+
+  struct ToggleItem {
+    const char *name;
+    uint8_t toggle_code;
+    bool (*is_on)(const SpaState &spaState);
+    uint16_t equipment;
+  };
+
+  ToggleSwitch() {};
+  void update(SpaState* spaState);
+  void set_parent(BalboaSpa *parent);
+  void set_switch_type(ToggleSwitchType _type);
+
+  protected:
+    void write_state(bool state) override;
+
+  private:
+    const ToggleItem *item = nullptr;
+    BalboaSpa *spa = nullptr;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
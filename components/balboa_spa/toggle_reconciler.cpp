@@ -0,0 +1,151 @@
+#include "esphome/core/log.h"
+#include "toggle_reconciler.h"
+#include "balboaspa.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+static const char *TAG = "BalboaSpa.toggle";
+
+// A toggle not reflected in the status by then is assumed lost on the bus
+static const uint32_t OBSERVE_TIMEOUT_MS = 3000;
+// A two-speed pump needs at most three toggles to walk its whole cycle
+static const uint8_t MAX_TOGGLES_PER_LEVEL_CHANGE = 3;
+
+struct ReconciledItem {
+    uint8_t toggle_code;
+    const char *name;
+    uint8_t (*level)(const SpaState &spaState);
+};
+
+// Pump levels are the raw two-bit status: 0 off, 1 low, 2 high (or on for one-speed pumps)
+static const ReconciledItem ITEMS[] = {
+    {TOGGLE_ITEM_PUMP1, "pump1", [](const SpaState &s) -> uint8_t { return s.pump1; }},
+    {TOGGLE_ITEM_PUMP2, "pump2", [](const SpaState &s) -> uint8_t { return s.pump2; }},
+    {TOGGLE_ITEM_PUMP3, "pump3", [](const SpaState &s) -> uint8_t { return s.pump3; }},
+    {TOGGLE_ITEM_PUMP4, "pump4", [](const SpaState &s) -> uint8_t { return s.pump4; }},
+    {TOGGLE_ITEM_PUMP5, "pump5", [](const SpaState &s) -> uint8_t { return s.pump5; }},
+    {TOGGLE_ITEM_PUMP6, "pump6", [](const SpaState &s) -> uint8_t { return s.pump6; }},
+    {TOGGLE_ITEM_BLOWER, "blower", [](const SpaState &s) -> uint8_t { return s.blower; }},
+    {TOGGLE_ITEM_MISTER, "mister", [](const SpaState &s) -> uint8_t { return s.mister; }},
+    {TOGGLE_ITEM_LIGHT1, "light", [](const SpaState &s) -> uint8_t { return s.light; }},
+    {TOGGLE_ITEM_LIGHT2, "light2", [](const SpaState &s) -> uint8_t { return s.light2; }},
+    {TOGGLE_ITEM_AUX1, "aux1", [](const SpaState &s) -> uint8_t { return s.aux1; }},
+    {TOGGLE_ITEM_AUX2, "aux2", [](const SpaState &s) -> uint8_t { return s.aux2; }},
+    {TOGGLE_ITEM_HIGH_RANGE, "high_range", [](const SpaState &s) -> uint8_t { return s.highrange; }},
+};
+
+static_assert(sizeof(ITEMS) / sizeof(ITEMS[0]) == ToggleReconciler::ITEM_COUNT,
+              "ITEMS must have ITEM_COUNT entries");
+
+bool ToggleReconciler::request(uint8_t toggle_code, uint8_t level, uint32_t now) {
+    for (uint8_t i = 0; i < ITEM_COUNT; i++) {
+        if (ITEMS[i].toggle_code != toggle_code) {
+            continue;
+        }
+        Pending &p = pending_[i];
+        if (p.desired == NONE) {
+            p.requested_at = now;
+        }
+        // A newer request replaces the old one; its toggles already on the wire still count
+        p.desired = level;
+        p.retries = 0;
+        p.toggles = 0;
+        ESP_LOGD(TAG, "Requested %s -> %d", ITEMS[i].name, level);
+        return true;
+    }
+    ESP_LOGW(TAG, "No reconciliation for toggle item 0x%02X", toggle_code);
+    return false;
+}
+
+bool ToggleReconciler::wants_on(uint8_t toggle_code, const SpaState &spaState) const {
+    for (uint8_t i = 0; i < ITEM_COUNT; i++) {
+        if (ITEMS[i].toggle_code == toggle_code) {
+            uint8_t desired = pending_[i].desired;
+            return desired != NONE ? desired != 0 : ITEMS[i].level(spaState) != 0;
+        }
+    }
+    return false;
+}
+
+void ToggleReconciler::on_status(const SpaState &spaState, uint32_t now) {
+    if (in_flight_ != NONE && ITEMS[in_flight_].level(spaState) != level_before_) {
+        in_flight_ = NONE;  // the toggle was seen, the next one may go out
+    }
+    expire(now);
+
+    for (uint8_t i = 0; i < ITEM_COUNT; i++) {
+        if (pending_[i].desired != NONE && in_flight_ != i && matches(ITEMS[i].level(spaState), pending_[i].desired)) {
+            finish(i, now, true);
+        }
+    }
+}
+
+uint8_t ToggleReconciler::next_toggle(const SpaState &spaState, uint32_t now) {
+    expire(now);
+    if (in_flight_ != NONE) {
+        return 0x00;
+    }
+
+    for (uint8_t i = 0; i < ITEM_COUNT; i++) {
+        Pending &p = pending_[i];
+        if (p.desired == NONE) {
+            continue;
+        }
+        uint8_t level = ITEMS[i].level(spaState);
+        if (matches(level, p.desired)) {
+            finish(i, now, true);
+            continue;
+        }
+        if (p.toggles >= MAX_TOGGLES_PER_LEVEL_CHANGE + max_retries_) {
+            ESP_LOGW(TAG, "Giving up on %s after %d toggles, level %d wanted %d", ITEMS[i].name, p.toggles, level, p.desired);
+            finish(i, now, false);
+            continue;
+        }
+        in_flight_ = i;
+        level_before_ = level;
+        sent_at_ = now;
+        p.toggles++;
+        ESP_LOGD(TAG, "Toggling %s (level %d, toggle %d)", ITEMS[i].name, level, p.toggles);
+        return ITEMS[i].toggle_code;
+    }
+    return 0x00;
+}
+
+void ToggleReconciler::expire(uint32_t now) {
+    if (in_flight_ == NONE || now - sent_at_ < OBSERVE_TIMEOUT_MS) {
+        return;
+    }
+    uint8_t index = in_flight_;
+    in_flight_ = NONE;
+    retries_++;
+
+    Pending &p = pending_[index];
+    if (p.desired == NONE) {
+        return;
+    }
+    p.retries++;
+    ESP_LOGD(TAG, "Toggle of %s not seen in status, retry %d/%d", ITEMS[index].name, p.retries, max_retries_);
+    if (p.retries > max_retries_) {
+        ESP_LOGW(TAG, "Giving up on %s, %d toggles were lost", ITEMS[index].name, p.retries);
+        finish(index, now, false);
+    }
+}
+
+void ToggleReconciler::finish(uint8_t index, uint32_t now, bool converged) {
+    Pending &p = pending_[index];
+    if (converged) {
+        // Requests that already matched the spa did not need reconciling
+        if (p.toggles > 0) {
+            converged_++;
+            last_convergence_ms_ = now - p.requested_at;
+            ESP_LOGD(TAG, "%s reached %d in %u ms", ITEMS[index].name, p.desired, (unsigned) last_convergence_ms_);
+        }
+    } else {
+        failures_++;
+    }
+    p = Pending();
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+
+#include "spa_state.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Drives toggle-only spa items (BF 11) to a desired state.
+ *
+ * The spa only understands "toggle", so the requested level is stored per
+ * item and one toggle at a time is handed out at clear-to-send. The next
+ * toggle is only released once a status frame shows the previous one took
+ * effect, or it timed out and is counted as a retry. Two-speed pumps step
+ * off -> low -> high -> off until the decoded level matches. An item whose
+ * retries exceed the budget is dropped with a warning.
+ */
+class ToggleReconciler {
+  public:
+    // Desired level meaning "on at any speed"
+    static const uint8_t LEVEL_ON = 0xFE;
+    // Pumps 1-6, blower, mister, lights 1-2, aux 1-2, high range
+    static const uint8_t ITEM_COUNT = 13;
+
+    void set_max_retries(uint8_t retries) { max_retries_ = retries; }
+
+    // Returns false for an item code the reconciler does not know
+    bool request(uint8_t toggle_code, uint8_t level, uint32_t now);
+    // Whether the item is on, or will be once its pending request converged; false for an unknown code
+    bool wants_on(uint8_t toggle_code, const SpaState &spaState) const;
+    // Called for every status frame, after the state has been decoded
+    void on_status(const SpaState &spaState, uint32_t now);
+    // Called at clear-to-send; returns the item code to toggle or 0x00
+    uint8_t next_toggle(const SpaState &spaState, uint32_t now);
+
+    bool busy() const { return in_flight_ != NONE; }
+    uint32_t converged() const { return converged_; }
+    uint32_t retries() const { return retries_; }
+    uint32_t failures() const { return failures_; }
+    // Time from request to matching status for the last converged item; NAN until one converged
+    float last_convergence_seconds() const { return converged_ == 0 ? NAN : last_convergence_ms_ / 1000.0f; }
+
+  private:
+    static const uint8_t NONE = 0xFF;
+
+    struct Pending {
+        uint8_t desired = NONE;
+        uint8_t retries = 0;
+        uint8_t toggles = 0;
+        uint32_t requested_at = 0;
+    };
+
+    static bool matches(uint8_t level, uint8_t desired) {
+        return desired == LEVEL_ON ? level != 0 : level == desired;
+    }
+    void expire(uint32_t now);
+    void finish(uint8_t index, uint32_t now, bool converged);
+
+    Pending pending_[ITEM_COUNT];
+    uint8_t max_retries_ = 3;
+    uint8_t in_flight_ = NONE;    // index of the item with a toggle on the wire
+    uint8_t level_before_ = 0;    // its level when the toggle was sent
+    uint32_t sent_at_ = 0;
+
+    uint32_t converged_ = 0;
+    uint32_t retries_ = 0;
+    uint32_t failures_ = 0;
+    uint32_t last_convergence_ms_ = 0;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,48 @@
+#include "verified_write.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+void VerifiedWrite::request(uint16_t value) {
+    // A newer value replaces one still waiting to be sent or confirmed
+    value_ = value;
+    pending_ = true;
+    sent_ = false;
+    attempts_ = 0;
+}
+
+void VerifiedWrite::mark_sent() {
+    sent_ = true;
+    frames_since_send_ = 0;
+    attempts_++;
+}
+
+VerifiedWrite::Outcome VerifiedWrite::on_status(bool matches) {
+    if (!pending_) {
+        return PENDING;
+    }
+    // Only a status after the write went out confirms it; one that merely matches already, possibly
+    // stale, must not cancel the request
+    if (attempts_ == 0) {
+        return PENDING;
+    }
+    if (matches) {
+        pending_ = false;
+        confirmed_++;
+        return CONFIRMED;
+    }
+    if (!sent_ || ++frames_since_send_ < confirm_frames_) {
+        return PENDING;
+    }
+    if (attempts_ > max_retries_) {
+        pending_ = false;
+        abandoned_++;
+        return ABANDONED;
+    }
+    sent_ = false;
+    retried_++;
+    return RETRY;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
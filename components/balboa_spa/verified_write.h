@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * Tracks one settable spa value (set temperature, clock) until a status
+ * frame confirms it.
+ *
+ * Only the latest requested value is kept, so a burst of changes sends one
+ * write. A value is always sent before it can be confirmed, even when the
+ * status already shows it. A sent value that is not seen within
+ * confirm_frames status frames is queued again, up to max_retries times,
+ * then abandoned.
+ */
+class VerifiedWrite {
+  public:
+    enum Outcome : uint8_t { PENDING, CONFIRMED, RETRY, ABANDONED };
+
+    void set_confirm_frames(uint8_t frames) { confirm_frames_ = frames; }
+    void set_max_retries(uint8_t retries) { max_retries_ = retries; }
+
+    void request(uint16_t value);
+    bool pending() const { return pending_; }
+    // True when the value should go out at the next clear-to-send
+    bool due() const { return pending_ && !sent_; }
+    uint16_t value() const { return value_; }
+    void mark_sent();
+
+    // Called for every status frame with whether it carries the requested value; stays PENDING until sent
+    Outcome on_status(bool matches);
+    // Sends of the current request, 0 while it has not gone out yet
+    uint8_t attempts() const { return attempts_; }
+
+    uint32_t confirmed() const { return confirmed_; }
+    uint32_t retried() const { return retried_; }
+    uint32_t abandoned() const { return abandoned_; }
+
+  private:
+    uint16_t value_ = 0;
+    bool pending_ = false;
+    bool sent_ = false;
+    uint8_t frames_since_send_ = 0;
+    uint8_t attempts_ = 0;
+    uint8_t confirm_frames_ = 5;
+    uint8_t max_retries_ = 3;
+
+    uint32_t confirmed_ = 0;
+    uint32_t retried_ = 0;
+    uint32_t abandoned_ = 0;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
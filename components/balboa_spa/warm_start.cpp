@@ -0,0 +1,70 @@
+#include "warm_start.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace balboa_spa {
+
+void SpaWarmStart::capture_state(const SpaState &spaState) {
+    pumps[0] = spaState.pump1;
+    pumps[1] = spaState.pump2;
+    pumps[2] = spaState.pump3;
+    pumps[3] = spaState.pump4;
+    pumps[4] = spaState.pump5;
+    pumps[5] = spaState.pump6;
+    blower = spaState.blower;
+    light = spaState.light;
+    light2 = spaState.light2;
+    mister = spaState.mister;
+    aux1 = spaState.aux1;
+    aux2 = spaState.aux2;
+    highrange = spaState.highrange;
+    circulation = spaState.circulation;
+    hour = spaState.hour;
+    minutes = spaState.minutes;
+    rest_mode = spaState.rest_mode;
+    heat_state = spaState.heat_state;
+    target_temp = spaState.target_temp;
+    current_temp = spaState.current_temp;
+    has_state = true;
+}
+
+void SpaWarmStart::apply_state(SpaState &spaState) const {
+    spaState.pump1 = pumps[0];
+    spaState.pump2 = pumps[1];
+    spaState.pump3 = pumps[2];
+    spaState.pump4 = pumps[3];
+    spaState.pump5 = pumps[4];
+    spaState.pump6 = pumps[5];
+    // decodeState() sets a jet when its pump runs at either speed
+    spaState.jet1 = pumps[0] != 0;
+    spaState.jet2 = pumps[1] != 0;
+    spaState.jet3 = pumps[2] != 0;
+    spaState.jet4 = pumps[3] != 0;
+    spaState.jet5 = pumps[4] != 0;
+    spaState.jet6 = pumps[5] != 0;
+    spaState.blower = blower;
+    spaState.light = light;
+    spaState.light2 = light2;
+    spaState.mister = mister;
+    spaState.aux1 = aux1;
+    spaState.aux2 = aux2;
+    spaState.highrange = highrange;
+    spaState.circulation = circulation;
+    spaState.hour = hour;
+    spaState.minutes = minutes;
+    spaState.rest_mode = rest_mode;
+    spaState.heat_state = heat_state;
+    spaState.target_temp = target_temp;
+    spaState.current_temp = current_temp;
+}
+
+bool SpaWarmStart::same_identity(const SpaWarmStart &other) const {
+    return client_id == other.client_id && has_config == other.has_config &&
+           has_filter_settings == other.has_filter_settings &&
+           std::memcmp(&config, &other.config, sizeof(config)) == 0 &&
+           std::memcmp(&filter_settings, &other.filter_settings, sizeof(filter_settings)) == 0;
+}
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "spa_types.h"
+#include "spa_config.h"
+#include "spa_state.h"
+
+namespace esphome {
+namespace balboa_spa {
+
+/**
+ * What the bus told us last, kept in flash so a reboot can start from it.
+ *
+ * Only values carried by bus frames are stored: the client ID, the
+ * configuration and filter cycle responses, and the decoded status. Filter
+ * and energy counters have their own preferences, and millis() based
+ * timestamps mean nothing after a reboot.
+ */
+struct SpaWarmStart {
+    uint8_t client_id;
+    bool has_config;
+    bool has_filter_settings;
+    bool has_state;
+    SpaConfig config;
+    SpaFilterSettings filter_settings;
+
+    // Status fields of SpaState, without its bit fields so the layout is plain
+    uint8_t pumps[6];
+    uint8_t blower;
+    uint8_t light;
+    uint8_t light2;
+    uint8_t mister;
+    uint8_t aux1;
+    uint8_t aux2;
+    uint8_t highrange;
+    uint8_t circulation;
+    uint8_t hour;
+    uint8_t minutes;
+    uint8_t rest_mode;
+    uint8_t heat_state;
+    float target_temp;
+    float current_temp;
+
+    void capture_state(const SpaState &spaState);
+    void apply_state(SpaState &spaState) const;
+    // Client ID, configuration and filter settings; these are saved as soon as they change
+    bool same_identity(const SpaWarmStart &other) const;
+};
+
+}  // namespace balboa_spa
+}  // namespace esphome
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Compare two balboa_bench JSON results and fail on regressions.
+
+Usage:
+    python3 scripts/bench_compare.py baseline.json current.json
+                                     [--max-slowdown 0.25] [--max-alloc-increase 0]
+
+A case regresses when its ns/op grows by more than --max-slowdown (as a
+fraction of the baseline) or its allocations per op grow by more than
+--max-alloc-increase. Cases present in only one file are listed but never
+fail the comparison. Exits 1 if any case regressed.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        return {b["name"]: b for b in json.load(f)["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--max-slowdown", type=float, default=0.25)
+    parser.add_argument("--max-alloc-increase", type=float, default=0.0)
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print(f"  {'case':<28} {'base ns':>10} {'ns':>10} {'change':>8} {'allocs':>12}")
+    for name in sorted(baseline.keys() | current.keys()):
+        if name not in baseline or name not in current:
+            print(f"  {name:<28} {'only in ' + ('current' if name in current else 'baseline'):>42}")
+            continue
+        base, cur = baseline[name], current[name]
+        change = cur["ns_per_op"] / base["ns_per_op"] - 1 if base["ns_per_op"] > 0 else 0.0
+        alloc_delta = cur["allocs_per_op"] - base["allocs_per_op"]
+        failed = change > args.max_slowdown or alloc_delta > args.max_alloc_increase
+        regressions += failed
+        print(f"  {name:<28} {base['ns_per_op']:>10.1f} {cur['ns_per_op']:>10.1f} {change:>+7.1%} "
+              f"{base['allocs_per_op']:>5.2f}->{cur['allocs_per_op']:<5.2f}{'  REGRESSION' if failed else ''}")
+
+    if regressions:
+        print(f"{regressions} case(s) regressed")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""Firmware size breakdown for the balboa_spa component.
+
+Reads the symbol table of a compiled ESPHome firmware and reports how much
+flash (code + constants) and RAM (initialised + zeroed data) each
+balboa_spa class uses, plus the largest individual symbols. When the
+firmware has debug info, it also reports sizeof() of the component's main
+types as laid out for the target, including the per-entity listener slot
+(a std::function plus the equipment bits).
+
+Usage:
+    python3 scripts/memory_report.py [--build-path .build/esphome_balboa_spa]
+                                     [--elf firmware.elf] [--nm xtensa-esp32-elf-nm]
+                                     [--readelf xtensa-esp32-elf-readelf]
+                                     [--top 15] [--json report.json]
+
+Heap usage (entities, listeners, queue buffers) is not visible in the ELF;
+it is logged by BalboaSpa::dump_config() at boot.
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+from collections import defaultdict
+
+NAMESPACE = "balboa_spa::"
+FLASH_TYPES = set("tTrRwW")
+RAM_TYPES = set("dDbBsSgG")
+
+# Types whose sizeof() is reported; a name ending in "<" matches any instantiation
+SIZE_TYPES = [
+    "BalboaSpa",
+    "SpaState",
+    "SpaConfig",
+    "SpaFaultLog",
+    "SpaFilterSettings",
+    "SpaListener",
+    "CircularBuffer<",
+    "FrameParser",
+    "SpaHistory",
+]
+
+
+def find_elf(build_path):
+    candidates = glob.glob(os.path.join(build_path, ".pioenvs", "*", "firmware.elf"))
+    if not candidates:
+        sys.exit(f"No firmware.elf found under {build_path}; run 'esphome compile' first")
+    return max(candidates, key=os.path.getmtime)
+
+
+def find_tool(name):
+    # Prefer the toolchain PlatformIO used for this build, fall back to the host tool
+    for prefix in ("xtensa-esp32*-elf-", "xtensa-lx106-elf-", "riscv32-esp-elf-"):
+        for tool_dir in glob.glob(os.path.expanduser("~/.platformio/packages/toolchain-*/bin")):
+            matches = glob.glob(os.path.join(tool_dir, prefix + name))
+            if matches:
+                return matches[0]
+    tool = shutil.which(name)
+    if tool is None:
+        sys.exit(f"No {name} found; pass --{name}")
+    return tool
+
+
+def read_symbols(nm, elf):
+    output = subprocess.run(
+        [nm, "--print-size", "--size-sort", "--demangle", elf],
+        check=True, capture_output=True, text=True,
+    ).stdout
+    for line in output.splitlines():
+        parts = line.split(maxsplit=3)
+        if len(parts) != 4:
+            continue
+        _, size, sym_type, name = parts
+        if NAMESPACE not in name:
+            continue
+        yield name, sym_type, int(size, 16)
+
+
+def read_type_sizes(readelf, elf):
+    """sizeof() of SIZE_TYPES from the DWARF info, {} if the ELF has none."""
+    sizes = {}
+    tag = name = byte_size = None
+
+    def record():
+        if tag in ("DW_TAG_class_type", "DW_TAG_structure_type") and name and byte_size is not None:
+            for wanted in SIZE_TYPES:
+                matches = name.startswith(wanted) if wanted.endswith("<") else name == wanted
+                if matches and name not in sizes:
+                    sizes[name] = byte_size
+
+    with subprocess.Popen([readelf, "--debug-dump=info", "--wide", elf],
+                          stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True) as proc:
+        for line in proc.stdout:
+            if "Abbrev Number" in line:
+                record()
+                tag = line.rsplit("(", 1)[-1].rstrip(")\n") if "(" in line else None
+                name = byte_size = None
+            elif "DW_AT_name" in line:
+                name = line.rsplit(": ", 1)[-1].strip()
+                if name.startswith("(") and ") " in name:
+                    name = name.split(") ", 1)[1]  # newer readelf prints the form, e.g. "(string) SpaState"
+            elif "DW_AT_byte_size" in line:
+                byte_size = int(line.split()[-1], 0)
+        record()
+    return sizes
+
+
+def owner_of(symbol):
+    # "esphome::balboa_spa::BalboaSpa::decodeState()" -> "BalboaSpa"
+    if not symbol.startswith("esphome::" + NAMESPACE) or " std::" in symbol.split("(", 1)[0]:
+        return "(library templates)"
+    rest = symbol.split(NAMESPACE, 1)[1]
+    head = rest.split("(", 1)[0]
+    depth = 0
+    for i, ch in enumerate(head):
+        depth += ch == "<"
+        depth -= ch == ">"
+        if depth == 0 and head.startswith("::", i):
+            return head[:i]
+    return "(free functions / data)"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--build-path", default=".build/esphome_balboa_spa")
+    parser.add_argument("--elf")
+    parser.add_argument("--nm")
+    parser.add_argument("--readelf")
+    parser.add_argument("--top", type=int, default=15)
+    parser.add_argument("--json", help="also write the report as JSON to this file")
+    args = parser.parse_args()
+
+    elf = args.elf or find_elf(args.build_path)
+    nm = args.nm or find_tool("nm")
+    readelf = args.readelf or find_tool("readelf")
+
+    per_owner = defaultdict(lambda: {"flash": 0, "ram": 0})
+    symbols = []
+    for name, sym_type, size in read_symbols(nm, elf):
+        region = "flash" if sym_type in FLASH_TYPES else "ram" if sym_type in RAM_TYPES else None
+        if region is None:
+            continue
+        per_owner[owner_of(name)][region] += size
+        symbols.append({"name": name, "region": region, "bytes": size})
+
+    total_flash = sum(o["flash"] for o in per_owner.values())
+    total_ram = sum(o["ram"] for o in per_owner.values())
+    symbols.sort(key=lambda s: s["bytes"], reverse=True)
+
+    print(f"balboa_spa footprint in {elf}")
+    print(f"  flash: {total_flash} bytes, static RAM: {total_ram} bytes")
+    print()
+    print(f"  {'class':<32} {'flash':>8} {'ram':>8}")
+    for owner, sizes in sorted(per_owner.items(), key=lambda kv: kv[1]["flash"] + kv[1]["ram"], reverse=True):
+        print(f"  {owner:<32} {sizes['flash']:>8} {sizes['ram']:>8}")
+    print()
+    print(f"  Top {args.top} symbols:")
+    for sym in symbols[:args.top]:
+        print(f"  {sym['bytes']:>8} {sym['region']:<5} {sym['name']}")
+
+    type_sizes = read_type_sizes(readelf, elf)
+    print()
+    if type_sizes:
+        print("  sizeof() on the target:")
+        for name, size in sorted(type_sizes.items(), key=lambda kv: kv[1], reverse=True):
+            print(f"  {size:>8} {name}")
+        if "SpaListener" in type_sizes:
+            print(f"  each entity adds one SpaListener ({type_sizes['SpaListener']} bytes) plus its own object")
+    else:
+        print("  sizeof() not available: the firmware has no debug info")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({
+                "elf": elf,
+                "flash_bytes": total_flash,
+                "ram_bytes": total_ram,
+                "classes": per_owner,
+                "top_symbols": symbols[:args.top],
+                "type_sizes": type_sizes,
+            }, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
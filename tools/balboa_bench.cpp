@@ -0,0 +1,378 @@
+// Host micro-benchmarks for each stage of the bus pipeline.
+//
+// Build (host, no ESPHome needed):
+//   g++ -std=c++17 -O2 -I components/balboa_spa -I tools/host -o balboa_bench tools/balboa_bench.cpp
+//       components/balboa_spa/spa_status.cpp components/balboa_spa/verified_write.cpp
+//
+// Usage:
+//   balboa_bench [--filter substring] [--min-time-ms 200] [--repeats 5] [--json results.json]
+//
+// Each case runs for at least --min-time-ms per repeat and reports the median
+// ns/op over the repeats plus heap allocations per op, counted by replacing the
+// global operator new. Results are written as JSON to stdout (or --json) and a
+// table to stderr. Compare two runs with scripts/bench_compare.py.
+//
+// Before timing anything, a few behaviour checks run on the same code; the
+// bench exits 1 if one fails, so CI catches those as well.
+//
+// Cases that exercise BalboaSpa members call the code those members run:
+// balboa_protocol.h, CircularBuffer and the status mapping in spa_status.cpp.
+// The parts that need ESPHome (UART, millis(), entity publishing) are not
+// included, and logging compiles to nothing (tools/host).
+
+#include "CircularBuffer.h"
+#include "balboa_protocol.h"
+#include "spa_status.h"
+#include "spa_types.h"
+#include "verified_write.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace esphome::balboa_spa;
+
+static std::atomic<uint64_t> allocation_count{0};
+
+void *operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+template<typename T> inline void do_not_optimize(T const &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+struct Settings {
+    const char *filter = nullptr;
+    double min_time_ms = 200;
+    int repeats = 5;
+    const char *json_path = nullptr;
+};
+
+// body(batch) performs `batch` operations
+template<typename Body> Result run_case(const Settings &settings, const std::string &name, Body body) {
+    using clock = std::chrono::steady_clock;
+    uint64_t batch = 1;
+    // Grow the batch until one run takes ~1/10 of the minimum time
+    for (;;) {
+        auto start = clock::now();
+        body(batch);
+        double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        if (ms >= settings.min_time_ms / 10 || batch >= (1ULL << 40)) break;
+        batch *= ms < 0.01 ? 100 : 2;
+    }
+
+    std::vector<double> samples;
+    uint64_t total_iterations = 0, total_allocs = 0;
+    for (int r = 0; r < settings.repeats; r++) {
+        uint64_t iterations = 0;
+        uint64_t allocs_before = allocation_count.load();
+        auto start = clock::now();
+        double ms = 0;
+        while (ms < settings.min_time_ms) {
+            body(batch);
+            iterations += batch;
+            ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        }
+        total_allocs += allocation_count.load() - allocs_before;
+        total_iterations += iterations;
+        samples.push_back(ms * 1e6 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return {name, total_iterations, samples[samples.size() / 2], double(total_allocs) / total_iterations};
+}
+
+std::vector<uint8_t> make_frame(std::initializer_list<uint8_t> message, size_t pad_to = 0) {
+    std::vector<uint8_t> body(message);
+    if (body.size() < pad_to) body.resize(pad_to, 0);
+    std::vector<uint8_t> frame(body.size() + 4);
+    frame.resize(protocol::encode_frame(body.data(), body.size(), frame.data(), frame.size()));
+    return frame;
+}
+
+protocol::ByteSpan span(const std::vector<uint8_t> &bytes) { return {bytes.data(), bytes.size()}; }
+
+// A status frame as broadcast by a BP-series board: 104F, 12:30, heating, pump 1 high, light on
+std::vector<uint8_t> status_frame() {
+    std::vector<uint8_t> message(24, 0);
+    message[0] = 0xFF;
+    message[1] = 0xAF;
+    message[2] = protocol::MSG_STATUS;
+    message[5] = 102;   // frame[7] current temperature
+    message[6] = 12;    // frame[8] hour
+    message[7] = 30;    // frame[9] minute
+    message[13] = 0x14; // frame[15] heating, high range
+    message[14] = 0x02; // frame[16] pump 1 high
+    message[16] = 0x02; // frame[18] circulation
+    message[17] = 0x03; // frame[19] light 1
+    message[23] = 104;  // frame[25] set temperature
+    message.resize(27, 0);
+    std::vector<uint8_t> frame(message.size() + 4);
+    frame.resize(protocol::encode_frame(message.data(), message.size(), frame.data(), frame.size()));
+    return frame;
+}
+
+// Returns the number of failed checks, each reported on stderr
+int run_checks() {
+    int failed = 0;
+    auto check = [&failed](bool ok, const char *what) {
+        if (!ok) {
+            fprintf(stderr, "check failed: %s\n", what);
+            failed++;
+        }
+    };
+
+    // A status that already shows the value, e.g. a stale one, must not confirm a write never sent
+    VerifiedWrite write;
+    write.request(100);
+    check(write.on_status(true) == VerifiedWrite::PENDING, "match before send stays pending");
+    check(write.due(), "match before send is still sent");
+    write.mark_sent();
+    check(write.on_status(true) == VerifiedWrite::CONFIRMED, "match after send confirms");
+    check(write.confirmed() == 1 && !write.pending(), "confirmed write is done");
+
+    // A late match after a retry was queued still counts, since the value went out once
+    VerifiedWrite retried;
+    retried.set_confirm_frames(1);
+    retried.request(200);
+    retried.mark_sent();
+    check(retried.on_status(false) == VerifiedWrite::RETRY, "missing match retries");
+    check(retried.on_status(true) == VerifiedWrite::CONFIRMED, "late match after a send confirms");
+
+    // Equipment the configuration did not report keeps its state
+    protocol::StatusMessage status{};
+    status.pumps[0] = 2;
+    status.pumps[2] = 1;
+    SpaState state;
+    state.jet3 = 0;
+    apply_status(status, EQUIPMENT_PUMP1, state);
+    check(state.jet1 == 1 && state.pump1 == 2, "present pump is mapped");
+    check(state.jet3 == 0, "absent pump is skipped");
+    return failed;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Settings settings;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            settings.filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            settings.min_time_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            settings.repeats = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            settings.json_path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: balboa_bench [--filter substring] [--min-time-ms N] [--repeats N] [--json file]\n");
+            return 2;
+        }
+    }
+
+    if (run_checks() != 0) {
+        return 1;
+    }
+
+    std::vector<Result> results;
+    auto bench = [&](const std::string &name, auto body) {
+        if (settings.filter != nullptr && name.find(settings.filter) == std::string::npos) return;
+        results.push_back(run_case(settings, name, body));
+        const Result &r = results.back();
+        fprintf(stderr, "%-28s %10.1f ns/op %8.2f allocs/op\n", r.name.c_str(), r.ns_per_op, r.allocs_per_op);
+    };
+
+    const auto status = status_frame();
+    const auto config = make_frame({0x10, 0xBF, protocol::MSG_CONFIGURATION, 0x1A, 0x00, 0x01, 0x90, 0x00, 0x00}, 9);
+    const auto filters = make_frame({0x10, 0xBF, protocol::MSG_FILTER_CYCLES, 20, 0, 1, 0, 0x88, 0, 1, 0}, 11);
+    const auto fault = make_frame({0x10, 0xBF, protocol::MSG_FAULT_LOG, 4, 1, 16, 2, 10, 30, 0, 0}, 11);
+    const auto cts = make_frame({0x10, 0xBF, protocol::MSG_CLEAR_TO_SEND});
+
+    // read_serial(): one byte through the parser, dispatching complete frames on type.
+    // The stream is a status frame followed by the CTS polls that fill a typical bus second.
+    std::vector<uint8_t> stream(status);
+    for (int i = 0; i < 8; i++) stream.insert(stream.end(), cts.begin(), cts.end());
+    bench("read_serial_per_byte", [&](uint64_t n) {
+        static protocol::FrameParser parser;
+        static size_t pos = 0;
+        uint32_t dispatched = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            if (parser.push(stream[pos]) == protocol::FrameParser::FRAME) {
+                dispatched += protocol::frame_type(parser.frame());
+            }
+            if (++pos == stream.size()) pos = 0;
+        }
+        do_not_optimize(dispatched);
+    });
+
+    for (size_t length : {5, 10, 20, 40}) {
+        std::vector<uint8_t> data(length);
+        for (size_t i = 0; i < length; i++) data[i] = static_cast<uint8_t>(i * 37 + 11);
+        bench("crc8_" + std::to_string(length), [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                do_not_optimize(data.data());
+                do_not_optimize(protocol::crc8(data.data(), data.size()));
+            }
+        });
+    }
+
+    // decodeState(): decode, then map the equipment into SpaState
+    bench("decode_state", [&](uint64_t n) {
+        protocol::StatusMessage out{};
+        SpaState state;
+        for (uint64_t i = 0; i < n; i++) {
+            do_not_optimize(status.data());
+            protocol::decode_status(span(status), out);
+            apply_status(out, EQUIPMENT_ALL, state);
+            do_not_optimize(state);
+        }
+    });
+
+    bench("decode_settings", [&](uint64_t n) {
+        protocol::ConfigMessage out{};
+        for (uint64_t i = 0; i < n; i++) {
+            do_not_optimize(config.data());
+            protocol::decode_config(span(config), out);
+            do_not_optimize(out);
+        }
+    });
+
+    bench("decode_filter_settings", [&](uint64_t n) {
+        protocol::FilterCyclesMessage out{};
+        for (uint64_t i = 0; i < n; i++) {
+            do_not_optimize(filters.data());
+            protocol::decode_filter_cycles(span(filters), out);
+            do_not_optimize(out);
+        }
+    });
+
+    // decodeFault() also copies the message text into SpaFaultLog::fault_message
+    bench("decode_fault", [&](uint64_t n) {
+        protocol::FaultLogMessage out{};
+        SpaFaultLog log{};
+        for (uint64_t i = 0; i < n; i++) {
+            do_not_optimize(fault.data());
+            protocol::decode_fault_log(span(fault), out);
+            log.fault_code = out.fault_code;
+            log.fault_message = protocol::fault_message(out.fault_code);
+            do_not_optimize(log);
+        }
+    });
+
+    // update_filter_status(): schedules, runtime and cycle counting, one status frame a second
+    // with the spa clock walking through the day, so both filters start and stop
+    bench("update_filter_status", [&](uint64_t n) {
+        SpaFilterSettings filters{};
+        filters.filter1_hour = 20;
+        filters.filter1_duration_hour = 2;
+        filters.filter2_enable = 1;
+        filters.filter2_hour = 8;
+        filters.filter2_duration_hour = 1;
+        filters.filter2_duration_minute = 30;
+        SpaState state;
+        state.filter1_running = state.filter2_running = false;
+        uint32_t now = 0, changes = 0;
+        for (uint64_t i = 0; i < n; i++) {
+            now += 1000;
+            uint32_t minute_of_day = (now / 60000) % 1440;
+            state.hour = minute_of_day / 60;
+            state.minutes = minute_of_day % 60;
+            changes += update_filter_runtime(filters, now, state).counters_changed;
+        }
+        do_not_optimize(changes);
+        do_not_optimize(state);
+    });
+
+    // Listener fan-out as in BalboaSpa::update(): null and equipment checks, then the std::function call.
+    // A third of the entities belong to a piece of equipment, a few of them absent.
+    struct Listener {
+        std::function<void(SpaState *)> callback;
+        uint16_t equipment;
+    };
+    for (size_t count : {10, 40, 100}) {
+        std::vector<float> states(count);
+        std::vector<Listener> listeners;
+        for (size_t i = 0; i < count; i++) {
+            float *target = &states[i];
+            auto publish = [target](SpaState *state) {
+                if (*target != state->current_temp) *target = state->current_temp;
+            };
+            listeners.push_back({publish, static_cast<uint16_t>(i % 3 == 0 ? 1 << (i % 13) : EQUIPMENT_NONE)});
+        }
+        const uint16_t present = EQUIPMENT_ALL & ~(EQUIPMENT_PUMP5 | EQUIPMENT_PUMP6 | EQUIPMENT_AUX2);
+        bench("listener_fanout_" + std::to_string(count), [&](uint64_t n) {
+            SpaState state;
+            state.current_temp = 0;
+            for (uint64_t i = 0; i < n; i++) {
+                state.current_temp += 0.5f;
+                for (const auto &listener : listeners) {
+                    if (listener.callback && spa_has_equipment(present, listener.equipment)) listener.callback(&state);
+                }
+            }
+            do_not_optimize(states.data());
+        });
+    }
+
+    // rs485_send(): a toggle command pushed into the long-lived output_queue, framed and cleared
+    CircularBuffer<uint8_t, 100> output_queue;  // as BalboaSpa::output_queue
+    bench("rs485_send", [&](uint64_t n) {
+        uint8_t frame[protocol::MAX_FRAME_SIZE];
+        for (uint64_t i = 0; i < n; i++) {
+            output_queue.push(0x10);
+            output_queue.push(protocol::MAGIC_TO_SPA);
+            output_queue.push(protocol::MSG_TOGGLE_ITEM);
+            output_queue.push(0x04);
+            output_queue.push(0x00);
+            do_not_optimize(protocol::encode_queued_frame(output_queue, frame, sizeof(frame)));
+            output_queue.clear();
+            do_not_optimize(frame);
+        }
+    });
+
+    // Set temperature: request, send at clear-to-send, confirm from the next status
+    bench("verified_write_confirm", [&](uint64_t n) {
+        VerifiedWrite write;
+        for (uint64_t i = 0; i < n; i++) {
+            write.request(static_cast<uint16_t>(i));
+            write.mark_sent();
+            do_not_optimize(write.on_status(true));
+        }
+        do_not_optimize(write.confirmed());
+    });
+
+    FILE *out = stdout;
+    if (settings.json_path != nullptr && (out = fopen(settings.json_path, "w")) == nullptr) {
+        perror(settings.json_path);
+        return 1;
+    }
+    fprintf(out, "{\"min_time_ms\":%g,\"repeats\":%d,\"benchmarks\":[", settings.min_time_ms, settings.repeats);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(out, "%s\n  {\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.3f,\"allocs_per_op\":%.3f}",
+                i ? "," : "", r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                r.allocs_per_op);
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,419 @@
+// Decodes raw Balboa RS-485 bus captures into one JSON object per frame.
+//
+// Build (host, no ESPHome needed):
+//   g++ -std=c++17 -O2 -I components/balboa_spa -o balboa_decode tools/balboa_decode.cpp
+//
+// Usage:
+//   balboa_decode [--hex | --binary] [--baud 115200] [--errors] [--quiet]
+//                 [--flip-bits RATE [--seed N]] [capture | -]
+//
+// Input is read in fixed-size chunks, so memory use does not grow with the
+// capture size. Binary captures are the raw UART byte stream; hex captures may
+// use any separators ("7E 05 10", "7e0510", "0x7E,0x05"). Without --hex or
+// --binary the format is guessed from the first chunk.
+//
+// Captures carry no timestamps, so "t_us" is the position of the frame's first
+// byte on the wire at the given baud rate (10 bits per byte). Pass --baud 0 to
+// omit it. A throughput summary is written to stderr at the end.
+//
+// --flip-bits injects noise: every bus bit is inverted with probability RATE
+// before parsing (deterministic for a given --seed). Comparing the frame count
+// with a clean run shows how much the parser's resynchronization recovers.
+//
+// Frames whose payload size is impossible for their message type are counted
+// as size errors and not decoded, like the component does.
+
+#include "balboa_protocol.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace esphome::balboa_spa;
+
+namespace {
+
+constexpr size_t READ_CHUNK_SIZE = 1 << 20;
+constexpr size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+
+enum class InputFormat { AUTO, BINARY, HEX };
+
+struct Options {
+    InputFormat format = InputFormat::AUTO;
+    uint32_t baud = 115200;
+    bool errors = false;
+    bool quiet = false;
+    double flip_rate = 0;
+    uint64_t seed = 1;
+    const char *path = "-";
+};
+
+struct Totals {
+    uint64_t bytes_in = 0;    // bytes read from the capture (text for hex input)
+    uint64_t bus_bytes = 0;   // decoded bus bytes fed to the parser
+    uint64_t frames = 0;
+    uint64_t crc_errors = 0;
+    uint64_t length_errors = 0;
+    uint64_t size_errors = 0;  // valid CRC, payload size impossible for the message type
+    uint64_t bits_flipped = 0;
+};
+
+const char *type_name(uint8_t type) {
+    switch (type) {
+        case protocol::MSG_NEW_CLIENT_CLEAR_TO_SEND: return "new_client_cts";
+        case protocol::MSG_CHANNEL_ASSIGNMENT_REQUEST: return "channel_request";
+        case protocol::MSG_CHANNEL_ASSIGNMENT: return "channel_assignment";
+        case protocol::MSG_CHANNEL_ASSIGNMENT_ACK: return "channel_ack";
+        case protocol::MSG_CLEAR_TO_SEND: return "cts";
+        case protocol::MSG_NOTHING_TO_SEND: return "nothing_to_send";
+        case protocol::MSG_TOGGLE_ITEM: return "toggle_item";
+        case protocol::MSG_STATUS: return "status";
+        case protocol::MSG_SET_TEMPERATURE: return "set_temperature";
+        case protocol::MSG_SET_TIME: return "set_time";
+        case protocol::MSG_SETTINGS_REQUEST: return "settings_request";
+        case protocol::MSG_FILTER_CYCLES: return "filter_cycles";
+        case protocol::MSG_FAULT_LOG: return "fault_log";
+        case protocol::MSG_CONFIGURATION: return "configuration";
+        case protocol::MSG_INFORMATION: return "information";
+        case protocol::MSG_PREFERENCES: return "preferences";
+        default: return "unknown";
+    }
+}
+
+// Appends to a fixed buffer and flushes it to stdout when it runs low
+class JsonWriter {
+  public:
+    JsonWriter() : buffer_(new char[OUTPUT_BUFFER_SIZE]) {}
+    ~JsonWriter() {
+        flush();
+        delete[] buffer_;
+    }
+
+    void printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+        if (OUTPUT_BUFFER_SIZE - size_ < 1024) {
+            flush();
+        }
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(buffer_ + size_, OUTPUT_BUFFER_SIZE - size_, format, args);
+        va_end(args);
+        if (written > 0) {
+            size_ += static_cast<size_t>(written);
+        }
+    }
+
+    void hex(protocol::ByteSpan bytes) {
+        static const char DIGITS[] = "0123456789ABCDEF";
+        if (OUTPUT_BUFFER_SIZE - size_ < bytes.size * 2 + 1024) {
+            flush();
+        }
+        for (size_t i = 0; i < bytes.size; i++) {
+            buffer_[size_++] = DIGITS[bytes[i] >> 4];
+            buffer_[size_++] = DIGITS[bytes[i] & 0x0F];
+        }
+    }
+
+    void flush() {
+        fwrite(buffer_, 1, size_, stdout);
+        size_ = 0;
+    }
+
+  private:
+    char *buffer_;
+    size_t size_ = 0;
+};
+
+void write_fields(JsonWriter &out, protocol::ByteSpan frame) {
+    switch (protocol::frame_type(frame)) {
+        case protocol::MSG_STATUS: {
+            protocol::StatusMessage s;
+            if (!protocol::decode_status(frame, s)) break;
+            out.printf(",\"fields\":{\"current_temp\":%u,\"target_temp\":%u,\"hour\":%u,\"minute\":%u,"
+                       "\"rest_mode\":%u,\"heat_state\":%u,\"high_range\":%u,\"pumps\":[%u,%u,%u,%u,%u,%u],"
+                       "\"circulation\":%u,\"blower\":%u,\"light1\":%u,\"light2\":%u,\"mister\":%u,"
+                       "\"aux1\":%u,\"aux2\":%u}",
+                       s.current_temp, s.target_temp, s.hour, s.minute, s.rest_mode, s.heat_state, s.high_range,
+                       s.pumps[0], s.pumps[1], s.pumps[2], s.pumps[3], s.pumps[4], s.pumps[5], s.circulation,
+                       s.blower, s.light1, s.light2, s.mister, s.aux1, s.aux2);
+            break;
+        }
+        case protocol::MSG_CONFIGURATION: {
+            protocol::ConfigMessage c;
+            if (!protocol::decode_config(frame, c)) break;
+            out.printf(",\"fields\":{\"pumps\":[%u,%u,%u,%u,%u,%u],\"light1\":%u,\"light2\":%u,"
+                       "\"circulation\":%u,\"blower\":%u,\"mister\":%u,\"aux1\":%u,\"aux2\":%u,"
+                       "\"temperature_scale\":%u}",
+                       c.pumps[0], c.pumps[1], c.pumps[2], c.pumps[3], c.pumps[4], c.pumps[5], c.light1, c.light2,
+                       c.circulation, c.blower, c.mister, c.aux1, c.aux2, c.temperature_scale);
+            break;
+        }
+        case protocol::MSG_FILTER_CYCLES: {
+            protocol::FilterCyclesMessage f;
+            if (!protocol::decode_filter_cycles(frame, f)) break;
+            out.printf(",\"fields\":{\"filter1_start\":\"%02u:%02u\",\"filter1_duration\":\"%02u:%02u\","
+                       "\"filter2_enable\":%u,\"filter2_start\":\"%02u:%02u\",\"filter2_duration\":\"%02u:%02u\"}",
+                       f.filter1_hour, f.filter1_minute, f.filter1_duration_hour, f.filter1_duration_minute,
+                       f.filter2_enable, f.filter2_hour, f.filter2_minute, f.filter2_duration_hour,
+                       f.filter2_duration_minute);
+            break;
+        }
+        case protocol::MSG_FAULT_LOG: {
+            protocol::FaultLogMessage f;
+            if (!protocol::decode_fault_log(frame, f)) break;
+            out.printf(",\"fields\":{\"total_entries\":%u,\"current_entry\":%u,\"fault_code\":%u,"
+                       "\"fault_message\":\"%s\",\"days_ago\":%u,\"hour\":%u,\"minute\":%u}",
+                       f.total_entries, f.current_entry, f.fault_code, protocol::fault_message(f.fault_code),
+                       f.days_ago, f.hour, f.minute);
+            break;
+        }
+        case protocol::MSG_INFORMATION: {
+            protocol::InformationMessage i;
+            if (!protocol::decode_information(frame, i)) break;
+            // The model is printable ASCII already; quotes and backslashes would still break the JSON
+            for (char *c = i.model; *c != '\0'; c++) {
+                if (*c == '"' || *c == '\\') *c = '?';
+            }
+            out.printf(",\"fields\":{\"software_id\":\"M%u_%u V%u.%u\",\"model\":\"%s\",\"setup\":%u,"
+                       "\"heater_voltage\":%u,\"heater_type\":%u,\"dip_switches\":%u}",
+                       i.software_id[0], i.software_id[1], i.software_id[2], i.software_id[3], i.model, i.setup,
+                       i.heater_voltage, i.heater_type, i.dip_switches);
+            break;
+        }
+        case protocol::MSG_PREFERENCES: {
+            protocol::PreferencesMessage p;
+            if (!protocol::decode_preferences(frame, p)) break;
+            out.printf(",\"fields\":{\"reminders\":%u,\"temperature_scale\":%u,\"clock_24h\":%u,"
+                       "\"cleanup_cycle\":%u,\"dolphin_address\":%u,\"m8_ai\":%u}",
+                       p.reminders, p.temperature_scale, p.clock_24h, p.cleanup_cycle, p.dolphin_address, p.m8_ai);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+class CaptureDecoder {
+  public:
+    CaptureDecoder(const Options &options, JsonWriter &out, Totals &totals)
+        : options_(options), out_(out), totals_(totals) {}
+
+    void push(uint8_t byte) {
+        totals_.bus_bytes++;
+        if (options_.flip_rate > 0) {
+            byte = inject_noise(byte);
+        }
+        // A rejected frame is rescanned, which can complete several buffered frames at once
+        for (auto result = parser_.push(byte); result != protocol::FrameParser::NEED_MORE &&
+                                               result != protocol::FrameParser::DROPPED;
+             result = parser_.poll()) {
+            switch (result) {
+                case protocol::FrameParser::FRAME: {
+                    protocol::SizeCheck size_check = protocol::check_payload_size(parser_.frame());
+                    if (size_check != protocol::SIZE_OK) {
+                        totals_.size_errors++;
+                        if (options_.errors) {
+                            write_error(size_check == protocol::SIZE_TOO_SHORT ? "too_short" : "too_long",
+                                        totals_.bus_bytes - parser_.buffered());
+                        }
+                        break;
+                    }
+                    totals_.frames++;
+                    if (!options_.quiet) write_frame(parser_.frame());
+                    break;
+                }
+                case protocol::FrameParser::CRC_ERROR:
+                    totals_.crc_errors++;
+                    if (options_.errors) write_error("crc");
+                    break;
+                case protocol::FrameParser::LENGTH_ERROR:
+                    totals_.length_errors++;
+                    if (options_.errors) write_error("length");
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    const protocol::FrameParser::Stats &stats() const { return parser_.stats(); }
+
+  private:
+    // xorshift64, good enough for noise and reproducible across platforms
+    double next_random() {
+        random_state_ ^= random_state_ << 13;
+        random_state_ ^= random_state_ >> 7;
+        random_state_ ^= random_state_ << 17;
+        return (random_state_ >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    uint8_t inject_noise(uint8_t byte) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (next_random() < options_.flip_rate) {
+                byte ^= 1 << bit;
+                totals_.bits_flipped++;
+            }
+        }
+        return byte;
+    }
+
+    void write_position(uint64_t offset) {
+        out_.printf("{\"offset\":%llu", static_cast<unsigned long long>(offset));
+        if (options_.baud != 0) {
+            out_.printf(",\"t_us\":%llu", static_cast<unsigned long long>(offset * 10000000ULL / options_.baud));
+        }
+    }
+
+    void write_frame(protocol::ByteSpan frame) {
+        uint8_t type = protocol::frame_type(frame);
+        // Bytes buffered behind the frame have already been counted
+        write_position(totals_.bus_bytes - parser_.buffered());
+        out_.printf(",\"channel\":%u,\"type\":\"%s\",\"type_id\":%u,\"raw\":\"", protocol::frame_channel(frame),
+                    type_name(type), type);
+        out_.hex(frame);
+        out_.printf("\"");
+        write_fields(out_, frame);
+        out_.printf("}\n");
+    }
+
+    // Errors are reported at the byte that revealed them
+    // Parser errors are reported where they were detected, size errors at the frame start
+    void write_error(const char *reason) { write_error(reason, totals_.bus_bytes - 1); }
+    void write_error(const char *reason, uint64_t position) {
+        write_position(position);
+        out_.printf(",\"error\":\"%s\"}\n", reason);
+    }
+
+    const Options &options_;
+    JsonWriter &out_;
+    Totals &totals_;
+    protocol::FrameParser parser_;
+    uint64_t random_state_ = options_.seed ? options_.seed : 1;
+};
+
+int hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Text is hex when it holds nothing but hex digits, whitespace and common separators
+bool looks_like_hex(const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        uint8_t c = data[i];
+        if (hex_value(c) < 0 && !strchr(" \t\r\n,:;x", c)) {
+            return false;
+        }
+    }
+    return size > 0;
+}
+
+void usage() {
+    fprintf(stderr, "usage: balboa_decode [--hex | --binary] [--baud N] [--errors] [--quiet]\n"
+                    "                     [--flip-bits RATE [--seed N]] [capture | -]\n");
+}
+
+bool parse_args(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hex") == 0) {
+            options.format = InputFormat::HEX;
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            options.format = InputFormat::BINARY;
+        } else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            options.baud = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--errors") == 0) {
+            options.errors = true;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            options.quiet = true;
+        } else if (strcmp(argv[i], "--flip-bits") == 0 && i + 1 < argc) {
+            options.flip_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            return false;
+        } else {
+            options.path = argv[i];
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    FILE *input = strcmp(options.path, "-") == 0 ? stdin : fopen(options.path, "rb");
+    if (input == nullptr) {
+        perror(options.path);
+        return 1;
+    }
+
+    Totals totals;
+    JsonWriter out;
+    CaptureDecoder decoder(options, out, totals);
+    uint8_t *chunk = new uint8_t[READ_CHUNK_SIZE];
+    int pending_nibble = -1;
+    auto started = std::chrono::steady_clock::now();
+
+    size_t read;
+    while ((read = fread(chunk, 1, READ_CHUNK_SIZE, input)) > 0) {
+        if (options.format == InputFormat::AUTO) {
+            options.format = looks_like_hex(chunk, read) ? InputFormat::HEX : InputFormat::BINARY;
+        }
+        totals.bytes_in += read;
+
+        if (options.format == InputFormat::BINARY) {
+            for (size_t i = 0; i < read; i++) {
+                decoder.push(chunk[i]);
+            }
+            continue;
+        }
+        // Hex digits pair up into bytes; any other character ends a pair, so "0x7E" reads as 7E
+        for (size_t i = 0; i < read; i++) {
+            int value = hex_value(chunk[i]);
+            if (value < 0) {
+                pending_nibble = -1;
+            } else if (pending_nibble < 0) {
+                pending_nibble = value;
+            } else {
+                decoder.push(static_cast<uint8_t>(pending_nibble << 4 | value));
+                pending_nibble = -1;
+            }
+        }
+    }
+    delete[] chunk;
+    out.flush();
+
+    if (ferror(input)) {
+        perror(options.path);
+    }
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (seconds <= 0) seconds = 1e-9;
+    const auto &stats = decoder.stats();
+    fprintf(stderr,
+            "input %llu bytes, bus %llu bytes, %llu frames, %llu crc errors, %llu length errors, "
+            "%llu size errors, %u bytes dropped, %u bytes lost to resync; %.3f s, %.1f MB/s, %.0f frames/s\n",
+            static_cast<unsigned long long>(totals.bytes_in), static_cast<unsigned long long>(totals.bus_bytes),
+            static_cast<unsigned long long>(totals.frames), static_cast<unsigned long long>(totals.crc_errors),
+            static_cast<unsigned long long>(totals.length_errors),
+            static_cast<unsigned long long>(totals.size_errors), static_cast<unsigned>(stats.bytes_dropped),
+            static_cast<unsigned>(stats.bytes_lost), seconds, totals.bytes_in / seconds / 1e6,
+            totals.frames / seconds);
+    if (options.flip_rate > 0) {
+        fprintf(stderr, "injected %llu bit errors (rate %g, seed %llu)\n",
+                static_cast<unsigned long long>(totals.bits_flipped), options.flip_rate,
+                static_cast<unsigned long long>(options.seed));
+    }
+    return 0;
+}